@@ -0,0 +1,92 @@
+/*
+ * Measures how many children per second are evaluated when each evaluation
+ * sleeps for between 1 and 10 ms, standing in for an external simulation.
+ * SimpleGA and SteadyStateGA evaluate batches of 'workers' children on as
+ * many threads, and wait for the slowest of each batch (SimpleGA also
+ * re-evaluates the survivors it mutates). SteadyStateGA's runAsync keeps
+ * every worker busy, so it approaches 'workers' evaluations per mean
+ * evaluation time (1450/s with 8 workers).
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/SteadyStateGA.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace evolve;
+
+using Genome = list1d::List1DFixed<double, 10>;
+
+const unsigned int workers = 8;
+const unsigned int children = 800;
+
+double slowSphere(const Genome& x) {
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(1000 + utils::random_uint(9000)));
+    double total = 0;
+    for (auto xi : x) {
+        total += xi * xi;
+    }
+    return total;
+}
+
+Genome generator() {
+    Genome x;
+    for (auto& xi : x) {
+        xi = utils::random_real() * 10 - 5;
+    }
+    return x;
+}
+
+template <typename Run>
+double childrenPerSecond(Run run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return children / elapsed.count();
+}
+
+int main() {
+    SimpleGA<Genome, 32> simple(
+        generator, slowSphere, list1d::crossover::uniformInto<Genome>,
+        list1d::mutator::gaussian<Genome>(0.1),
+        selector::top<Genome, 32 - workers, Ordering::LOWER>);
+    simple.setOrdering(Ordering::LOWER);
+    simple.setEvaluationThreads(workers);
+    simple.initialize();
+    auto simpleRate = childrenPerSecond([&]() {
+        for (auto i = 0U; i < children / workers; ++i) {
+            simple.step();
+        }
+    });
+
+    SteadyStateGA<Genome, 32> batch(generator, slowSphere,
+                                    list1d::crossover::uniformInto<Genome>,
+                                    list1d::mutator::gaussian<Genome>(0.1));
+    batch.setOrdering(Ordering::LOWER);
+    batch.setOffspring(workers);
+    batch.setEvaluationThreads(workers);
+    batch.initialize();
+    auto batchRate = childrenPerSecond([&]() {
+        for (auto i = 0U; i < children / workers; ++i) {
+            batch.step();
+        }
+    });
+
+    SteadyStateGA<Genome, 32> async(generator, slowSphere,
+                                    list1d::crossover::uniformInto<Genome>,
+                                    list1d::mutator::gaussian<Genome>(0.1));
+    async.setOrdering(Ordering::LOWER);
+    async.setAsyncEvaluation(workers);
+    // The time includes evaluating the initial population
+    auto asyncRate = childrenPerSecond([&]() { async.runAsync(children, 0); });
+
+    std::cout << "Evaluations of 1-10 ms on " << workers
+              << " workers: SimpleGA " << simpleRate
+              << " children/s, SteadyStateGA " << batchRate
+              << " children/s, SteadyStateGA::runAsync " << asyncRate
+              << " children/s" << std::endl;
+}
@@ -0,0 +1,85 @@
+/*
+ * Compares the speed of a GA over 4000 boolean genes held as a
+ * List1D<bool> (std::vector<bool>), a List1D<char> and a packed BitString.
+ * Each uses uniform crossover and flips each gene with probability
+ * 1/4000, and scores the number of genes matching a hidden target.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include "cppEvolve/Genome/BitString/Crossover.hpp"
+#include "cppEvolve/Genome/BitString/Mutator.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+using namespace evolve;
+using bitstring::BitString;
+
+const std::size_t numGenes = 4000;
+const double flipProbability = 1.0 / numGenes;
+
+template <typename Genome>
+void run(const std::string& name, GeneratorType<Genome> generator,
+         EvaluatorType<Genome> evaluator, CrossoverIntoType<Genome> crossover,
+         MutatorType<Genome> mutator) {
+    SimpleGA<Genome, 200> ga(generator, evaluator, crossover, mutator,
+                             selector::top<Genome, 40>);
+    ga.setMutationRate(0.5f);
+
+    const unsigned int generations = 500;
+    auto start = std::chrono::steady_clock::now();
+    ga.initialize();
+    for (auto i = 0U; i < generations; ++i) {
+        ga.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << name << "best " << ga.getBestScore() << " ("
+              << generations / elapsed.count() << " generations/s)"
+              << std::endl;
+}
+
+// Flip each allele with flipProbability, for the List1D genomes
+template <typename Genome>
+void flipAlleles(Genome& g) {
+    utils::GeometricSkip skip(flipProbability);
+    for (auto i = skip(); i < g.size(); i += 1 + skip()) {
+        g[i] = !g[i];
+    }
+}
+
+template <typename Genome>
+void runList(const std::string& name, const BitString& target) {
+    run<Genome>(name,
+                []() {
+                    Genome g(numGenes);
+                    for (std::size_t i = 0; i < numGenes; ++i) {
+                        g[i] = utils::random_uint(2);
+                    }
+                    return g;
+                },
+                [&target](const Genome& g) {
+                    std::size_t correct = 0;
+                    for (std::size_t i = 0; i < numGenes; ++i) {
+                        correct += bool(g[i]) == target[i];
+                    }
+                    return double(correct);
+                },
+                list1d::crossover::uniformInto<Genome>, flipAlleles<Genome>);
+}
+
+int main() {
+    const auto target = BitString::random(numGenes);
+
+    runList<list1d::List1D<bool>>("List1D<bool>:  ", target);
+    runList<list1d::List1D<char>>("List1D<char>:  ", target);
+    run<BitString>("BitString:     ",
+                   []() { return BitString::random(numGenes); },
+                   [&target](const BitString& g) {
+                       return double(numGenes - bitstring::hamming(g, target));
+                   },
+                   bitstring::crossover::uniformInto,
+                   bitstring::mutator::flip(flipProbability));
+}
@@ -0,0 +1,129 @@
+/*
+ * Measures SimpleGA generations per second on a 5000 city travelling
+ * salesman problem in which most of the population survives each generation
+ * and is mutated again. Swap mutations are scored by evaluating the whole
+ * path, then by the delta of the edges next to the swapped positions, and
+ * finally inversions (2-opt moves) by the delta of the two edges they
+ * replace.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+using namespace evolve;
+
+const std::size_t numCities = 5000;
+using Genome = list1d::List1D<unsigned int>;
+
+std::vector<double> xs, ys;
+
+double distance(unsigned int a, unsigned int b) {
+    return std::hypot(xs[a] - xs[b], ys[a] - ys[b]);
+}
+
+double pathLength(const Genome& path) {
+    double total = 0;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        total += distance(path[i], path[i + 1]);
+    }
+    return total;
+}
+
+// The length of the edges leaving the positions around a change, with the
+// cities at change.first and change.second taken to be 'a' and 'b'
+double edgesAround(const Genome& path, const Change& change, unsigned int a,
+                   unsigned int b) {
+    auto city = [&](std::size_t i) {
+        return (i == change.first) ? a
+                                   : (i == change.second) ? b : path[i];
+    };
+    double total = 0;
+    for (auto i : {change.first - 1, change.first, change.second - 1,
+                   change.second}) {
+        if (i >= path.size() - 1 ||
+            (i == change.second - 1 && i == change.first))
+            continue;
+        total += distance(city(i), city(i + 1));
+    }
+    return total;
+}
+
+double swapLength(const Genome& path, const Change& change, double before) {
+    const auto a = path[change.first], b = path[change.second];
+    return before - edgesAround(path, change, b, a) +
+           edgesAround(path, change, a, b);
+}
+
+// A reversal of [first, second] replaces the edges entering and leaving it
+double inversionLength(const Genome& path, const Change& change,
+                       double before) {
+    double total = before;
+    if (change.first > 0) {
+        const auto previous = path[change.first - 1];
+        total += distance(previous, path[change.first]) -
+                 distance(previous, path[change.second]);
+    }
+    if (change.second + 1 < path.size()) {
+        const auto next = path[change.second + 1];
+        total += distance(path[change.second], next) -
+                 distance(path[change.first], next);
+    }
+    return total;
+}
+
+enum class Scoring { FULL, DELTA_SWAP, DELTA_INVERSION };
+
+double run(Scoring scoring, double& best) {
+    auto generator = []() {
+        Genome path(numCities);
+        std::iota(path.begin(), path.end(), 0);
+        return path;
+    };
+
+    SimpleGA<Genome, 100> ga(generator, pathLength,
+                             list1d::crossover::randomCopyInto<Genome>,
+                             list1d::mutator::swap<Genome>,
+                             selector::top<Genome, 90, Ordering::LOWER>);
+    ga.setOrdering(Ordering::LOWER);
+    ga.setMutationRate(5.0f);
+    if (scoring == Scoring::DELTA_SWAP) {
+        ga.setDeltaMutator(list1d::mutator::deltaSwap<Genome>, swapLength);
+    } else if (scoring == Scoring::DELTA_INVERSION) {
+        ga.setDeltaMutator(list1d::mutator::deltaInversion<Genome>,
+                           inversionLength);
+    }
+
+    const unsigned int generations = 200;
+    auto start = std::chrono::steady_clock::now();
+    ga.initialize();
+    for (auto i = 0U; i < generations; ++i) {
+        ga.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    best = ga.getBestScore();
+    return generations / elapsed.count();
+}
+
+int main() {
+    for (std::size_t i = 0; i < numCities; ++i) {
+        xs.push_back(utils::random_real());
+        ys.push_back(utils::random_real());
+    }
+
+    double best;
+    auto full = run(Scoring::FULL, best);
+    std::cout << "Swap, full evaluation:       " << full
+              << " generations/s (best " << best << ")" << std::endl;
+    auto delta = run(Scoring::DELTA_SWAP, best);
+    std::cout << "Swap, delta evaluation:      " << delta
+              << " generations/s (best " << best << ")" << std::endl;
+    auto inversion = run(Scoring::DELTA_INVERSION, best);
+    std::cout << "Inversion, delta evaluation: " << inversion
+              << " generations/s (best " << best << ")" << std::endl;
+}
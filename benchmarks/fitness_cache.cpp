@@ -0,0 +1,73 @@
+/*
+ * Measures SimpleGA generations per second on a travelling salesman problem
+ * whose children are mostly copies of their parents, with and without a
+ * FitnessCache.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+using namespace evolve;
+
+const std::size_t numCities = 200;
+using Genome = list1d::List1DFixed<unsigned int, numCities>;
+
+std::vector<double> xs, ys;
+
+double pathLength(const Genome& path) {
+    double total = 0;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        total += std::hypot(xs[path[i]] - xs[path[i + 1]],
+                            ys[path[i]] - ys[path[i + 1]]);
+    }
+    return total;
+}
+
+double run(std::size_t cacheSize, double& best, double& hitRate) {
+    auto generator = []() {
+        Genome path;
+        std::iota(path.begin(), path.end(), 0);
+        return path;
+    };
+
+    SimpleGA<Genome, 2000> ga(generator, pathLength,
+                              list1d::crossover::randomCopy<Genome>,
+                              list1d::mutator::swap<Genome>,
+                              selector::top<Genome, 200, Ordering::LOWER>);
+    ga.setOrdering(Ordering::LOWER);
+    ga.setMutationRate(0.1f);
+    ga.setFitnessCache(cacheSize);
+
+    const unsigned int generations = 200;
+    auto start = std::chrono::steady_clock::now();
+    ga.initialize();
+    for (auto i = 0U; i < generations; ++i) {
+        ga.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    best = ga.getBestScore();
+    hitRate = cacheSize ? ga.getFitnessCache()->getHitRate() : 0;
+    return generations / elapsed.count();
+}
+
+int main() {
+    for (std::size_t i = 0; i < numCities; ++i) {
+        xs.push_back(utils::random_real());
+        ys.push_back(utils::random_real());
+    }
+
+    double best, hitRate;
+    auto plain = run(0, best, hitRate);
+    std::cout << "SimpleGA, no cache:      " << plain
+              << " generations/s (best " << best << ")" << std::endl;
+    auto cached = run(4096, best, hitRate);
+    std::cout << "SimpleGA, fitness cache: " << cached
+              << " generations/s (best " << best << ", hit rate " << hitRate
+              << ")" << std::endl;
+}
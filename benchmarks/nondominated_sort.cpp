@@ -0,0 +1,100 @@
+/*
+ * Compares pareto::sortFronts (ENS-BS) with the fast non-dominated sort of
+ * the original NSGA-II paper, which compares every pair of points, on random
+ * points with 2 and 3 objectives.
+ */
+
+#include "cppEvolve/Pareto.hpp"
+#include "cppEvolve/Random.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace evolve;
+
+template <typename F>
+double seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Deb et al.: count the dominators of each point, then peel off the fronts.
+// O(M N^2).
+template <std::size_t M>
+void pairwiseSort(const std::vector<pareto::Point<M>>& points,
+                  std::vector<unsigned int>& rank) {
+    const auto n = points.size();
+    std::vector<std::vector<std::size_t>> dominated(n);
+    std::vector<std::size_t> count(n, 0), current, next;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            if (pareto::dominates(points[i], points[j])) {
+                dominated[i].push_back(j);
+                ++count[j];
+            } else if (pareto::dominates(points[j], points[i])) {
+                dominated[j].push_back(i);
+                ++count[i];
+            }
+        }
+    }
+
+    rank.assign(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (count[i] == 0)
+            current.push_back(i);
+    }
+    for (unsigned int front = 0; !current.empty(); ++front) {
+        next.clear();
+        for (auto i : current) {
+            rank[i] = front;
+            for (auto j : dominated[i]) {
+                if (--count[j] == 0)
+                    next.push_back(j);
+            }
+        }
+        current.swap(next);
+    }
+}
+
+template <std::size_t M>
+void compare(std::size_t n) {
+    const unsigned int repeats = 20;
+    std::vector<pareto::Point<M>> points(n);
+    for (auto& point : points) {
+        for (auto& value : point) {
+            // Few distinct values, so that there are ties and duplicates
+            value = utils::random_uint(n / 4);
+        }
+    }
+
+    std::vector<unsigned int> rank, expected;
+    std::vector<std::vector<std::size_t>> fronts;
+    std::vector<std::size_t> order;
+    auto ens = seconds([&]() {
+        for (unsigned int r = 0; r < repeats; ++r) {
+            pareto::sortFronts(points, rank, fronts, order);
+        }
+    });
+    auto pairwise = seconds([&]() {
+        for (unsigned int r = 0; r < repeats; ++r) {
+            pairwiseSort(points, expected);
+        }
+    });
+
+    std::cout << M << " objectives, " << n << " points: ENS-BS "
+              << ens / repeats * 1e3 << " ms, pairwise "
+              << pairwise / repeats * 1e3 << " ms"
+              << (rank == expected ? "" : " (ranks disagree)") << std::endl;
+}
+
+int main() {
+    compare<2>(200);
+    compare<2>(2000);
+    compare<3>(200);
+    compare<3>(2000);
+    compare<5>(2000);
+}
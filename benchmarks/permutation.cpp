@@ -0,0 +1,80 @@
+/*
+ * Compares the tours found for a 100 city travelling salesman problem by
+ * mutation only search (randomCopy with swaps) and by the permutation
+ * crossovers with inversion mutations, after the same number of generations.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+using namespace evolve;
+
+const std::size_t numCities = 100;
+using Genome = list1d::List1DFixed<unsigned int, numCities>;
+
+std::vector<double> xs, ys;
+
+double pathLength(const Genome& path) {
+    double total = 0;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+        total += std::hypot(xs[path[i]] - xs[path[i + 1]],
+                            ys[path[i]] - ys[path[i + 1]]);
+    }
+    return total;
+}
+
+void run(const std::string& name, CrossoverIntoType<Genome> crossover,
+         MutatorType<Genome> mutator) {
+    auto generator = []() {
+        Genome path;
+        std::iota(path.begin(), path.end(), 0);
+        std::shuffle(path.begin(), path.end(), utils::engine());
+        return path;
+    };
+
+    SimpleGA<Genome, 500> ga(generator, pathLength, crossover, mutator,
+                             selector::top<Genome, 50, Ordering::LOWER>);
+    ga.setOrdering(Ordering::LOWER);
+    ga.setMutationRate(0.3f);
+
+    const unsigned int generations = 500;
+    auto start = std::chrono::steady_clock::now();
+    ga.initialize();
+    for (auto i = 0U; i < generations; ++i) {
+        ga.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    std::cout << name << "best " << ga.getBestScore() << " ("
+              << generations / elapsed.count() << " generations/s)"
+              << std::endl;
+}
+
+int main() {
+    for (std::size_t i = 0; i < numCities; ++i) {
+        xs.push_back(utils::random_real());
+        ys.push_back(utils::random_real());
+    }
+
+    run("randomCopy, swap:              ",
+        list1d::crossover::randomCopyInto<Genome>,
+        list1d::mutator::swap<Genome>);
+    run("ordered (OX), inversion:       ",
+        list1d::crossover::orderedInto<Genome>,
+        list1d::mutator::inversion<Genome>);
+    run("partiallyMapped, inversion:    ",
+        list1d::crossover::partiallyMappedInto<Genome>,
+        list1d::mutator::inversion<Genome>);
+    run("cycle, inversion:              ",
+        list1d::crossover::cycleInto<Genome>,
+        list1d::mutator::inversion<Genome>);
+    run("edgeRecombination, inversion:  ",
+        list1d::crossover::edgeRecombinationInto<Genome>,
+        list1d::mutator::inversion<Genome>);
+}
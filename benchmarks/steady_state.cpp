@@ -0,0 +1,72 @@
+/*
+ * Measures how many children per second are bred, evaluated and inserted
+ * into populations of increasing size, by SteadyStateGA and by a SimpleGA
+ * whose selector keeps all but one member each generation (so that it also
+ * breeds one child at a time). The evaluator is cheap, so the cost is that
+ * of inserting the child: O(log N) for SteadyStateGA and O(N) for SimpleGA.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/SteadyStateGA.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <chrono>
+#include <iostream>
+
+using namespace evolve;
+
+using Genome = list1d::List1DFixed<double, 10>;
+
+double sphere(const Genome& x) {
+    double total = 0;
+    for (auto xi : x) {
+        total += xi * xi;
+    }
+    return total;
+}
+
+Genome generator() {
+    Genome x;
+    for (auto& xi : x) {
+        xi = utils::random_real() * 10 - 5;
+    }
+    return x;
+}
+
+template <typename GA>
+double childrenPerSecond(GA& ga, unsigned int children) {
+    ga.setOrdering(Ordering::LOWER);
+    ga.initialize();
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0U; i < children; ++i) {
+        ga.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return children / elapsed.count();
+}
+
+template <std::size_t N>
+void compare() {
+    const unsigned int children = 200000;
+    SteadyStateGA<Genome, N> steady(generator, sphere,
+                                    list1d::crossover::uniformInto<Genome>,
+                                    list1d::mutator::gaussian<Genome>(0.1));
+    auto steadyRate = childrenPerSecond(steady, children);
+
+    SimpleGA<Genome, N> simple(generator, sphere,
+                               list1d::crossover::uniformInto<Genome>,
+                               list1d::mutator::gaussian<Genome>(0.1),
+                               selector::top<Genome, N - 1, Ordering::LOWER>);
+    simple.setMutationRate(0.6f / N);
+    auto simpleRate = childrenPerSecond(simple, children * 100 / N);
+
+    std::cout << "Population " << N << ": SteadyStateGA " << steadyRate
+              << " children/s (best " << steady.getBestScore()
+              << "), SimpleGA " << simpleRate << " children/s" << std::endl;
+}
+
+int main() {
+    compare<100>();
+    compare<1000>();
+    compare<10000>();
+}
@@ -0,0 +1,155 @@
+/*
+ * Compares the cost of evaluating random trees over many input rows with
+ * Tree::eval, FlatTree::eval (of the same trees, flattened) and a compiled
+ * Program, row by row and in column blocks (with the built-in kernels,
+ * vectorized when compiled with -mavx2), and finally after tree::simplify.
+ */
+
+#include "cppEvolve/Genome/Tree/Program.hpp"
+#include "cppEvolve/Genome/Tree/Simplify.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace evolve;
+
+namespace nodes
+{
+    double sum(double x, double y) { return x+y; }
+    double product(double x, double y) { return x*y; }
+    double difference(double x, double y) { return x-y; }
+    double negative(double x) { return -x; }
+    double half() { return 0.5; }
+}
+
+template <typename F>
+double seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+    const std::size_t numTrees = 100, rows = 10000, columns = 2;
+
+    tree::TreeFactory<double> factory(6);
+    factory.addNode(nodes::sum, "sum");
+    factory.addNode(nodes::product, "product");
+    factory.addNode(nodes::difference, "difference");
+    factory.addNode(nodes::negative, "negative");
+    factory.addTerminator(nodes::half, "0.5");
+    factory.addInput("x", 0);
+    factory.addInput("y", 1);
+
+    // The same trees built from kernels, for block evaluation. Kernels are
+    // pure, so repeated subtrees are shared by their programs.
+    tree::TreeFactory<double> kernelFactory(6);
+    kernelFactory.addKernel<tree::kernels::Add>("sum");
+    kernelFactory.addKernel<tree::kernels::Multiply>("product");
+    kernelFactory.addKernel<tree::kernels::Subtract>("difference");
+    kernelFactory.addKernel<tree::kernels::Negate>("negative");
+    kernelFactory.addTerminator(nodes::half, "0.5",
+                                tree::NodeTraits<double>().setConstant());
+    kernelFactory.addInput("x", 0);
+    kernelFactory.addInput("y", 1);
+
+    // Row major for evalRows, column major for evalColumns
+    std::vector<double> data(rows * columns), columnData(rows * columns);
+    for (std::size_t r = 0; r < rows; ++r) {
+        for (std::size_t c = 0; c < columns; ++c) {
+            data[r * columns + c] = utils::random_real();
+            columnData[c * rows + r] = data[r * columns + c];
+        }
+    }
+
+    std::vector<tree::Tree<double>*> trees;
+    std::vector<tree::FlatTree<double>> flatTrees;
+    std::vector<tree::Program<double>> programs, kernelPrograms,
+        simplePrograms;
+    std::size_t nodeCount = 0, simpleCount = 0;
+    for (std::size_t i = 0; i < numTrees; ++i) {
+        trees.push_back(factory.make());
+        flatTrees.push_back(factory.flatten(*trees.back()));
+        programs.emplace_back(*trees.back(), factory);
+        kernelPrograms.emplace_back(*trees.back(), kernelFactory);
+
+        std::unique_ptr<tree::Tree<double>> simple(trees.back()->clone());
+        nodeCount += simple->getSize();
+        tree::simplify(*simple, kernelFactory);
+        simpleCount += simple->getSize();
+        simplePrograms.emplace_back(*simple, kernelFactory);
+    }
+
+    std::vector<double> out(rows);
+
+    auto treeTime = seconds([&]() {
+        for (auto tree : trees) {
+            for (std::size_t r = 0; r < rows; ++r) {
+                out[r] = tree->eval(&data[r * columns]);
+            }
+        }
+    });
+
+    auto flatTime = seconds([&]() {
+        for (const auto& tree : flatTrees) {
+            for (std::size_t r = 0; r < rows; ++r) {
+                out[r] = tree.eval(&data[r * columns]);
+            }
+        }
+    });
+
+    auto programTime = seconds([&]() {
+        for (const auto& program : programs) {
+            program.evalRows(data.data(), rows, columns, out.data());
+        }
+    });
+
+    auto columnTime = seconds([&]() {
+        for (const auto& program : programs) {
+            program.evalColumns(columnData.data(), rows, out.data());
+        }
+    });
+
+    auto kernelTime = seconds([&]() {
+        for (const auto& program : kernelPrograms) {
+            program.evalColumns(columnData.data(), rows, out.data());
+        }
+    });
+
+    auto simpleTime = seconds([&]() {
+        for (const auto& program : simplePrograms) {
+            program.evalColumns(columnData.data(), rows, out.data());
+        }
+    });
+
+    auto mismatches = 0U;
+    std::vector<double> simpleOut(rows);
+    for (std::size_t i = 0; i < numTrees; ++i) {
+        kernelPrograms[i].evalColumns(columnData.data(), rows, out.data());
+        simplePrograms[i].evalColumns(columnData.data(), rows,
+                                      simpleOut.data());
+        for (std::size_t r = 0; r < rows; ++r) {
+            const auto expected = trees[i]->eval(&data[r * columns]);
+            if (out[r] != expected || simpleOut[r] != expected ||
+                flatTrees[i].eval(&data[r * columns]) != expected) {
+                ++mismatches;
+                break;
+            }
+        }
+        delete trees[i];
+    }
+
+    const double evals = numTrees * rows;
+    std::cout << "Tree::eval      " << evals / treeTime << " rows/s\n"
+              << "FlatTree::eval  " << evals / flatTime << " rows/s\n"
+              << "Program rows    " << evals / programTime << " rows/s\n"
+              << "Program columns " << evals / columnTime << " rows/s\n"
+              << "Kernel columns  " << evals / kernelTime << " rows/s\n"
+              << "Simplified      " << evals / simpleTime << " rows/s ("
+              << simpleCount << " of " << nodeCount << " nodes)\n"
+              << "Programs or flat trees disagreeing with their tree: " << mismatches
+              << std::endl;
+}
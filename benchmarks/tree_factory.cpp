@@ -0,0 +1,79 @@
+/*
+ * Measures how quickly a TreeFactory with 16 node functions and 16
+ * terminators makes random trees, and how quickly those trees are evaluated
+ * with Tree::eval.
+ */
+
+#include "cppEvolve/Genome/Tree/Tree.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace evolve;
+
+namespace nodes
+{
+    template <int N>
+    double scaledSum(double x, double y) { return x + N * y; }
+
+    template <int N>
+    double constant() { return N; }
+}
+
+template <int N>
+void addFunctions(tree::TreeFactory<double>& factory) {
+    factory.addNode(nodes::scaledSum<N>, "sum" + std::to_string(N));
+    factory.addTerminator(nodes::constant<N>, std::to_string(N));
+}
+
+template <int... N>
+void addAll(tree::TreeFactory<double>& factory) {
+    int expand[] = {(addFunctions<N>(factory), 0)...};
+    (void)expand;
+}
+
+template <typename F>
+double seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main() {
+    const std::size_t numTrees = 20000, evaluations = 20;
+
+    tree::TreeFactory<double> factory(7);
+    addAll<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>(factory);
+
+    std::vector<tree::Tree<double>*> trees;
+    std::size_t nodes = 0;
+    auto making = seconds([&]() {
+        for (std::size_t i = 0; i < numTrees; ++i) {
+            trees.push_back(factory.make());
+        }
+    });
+    for (auto t : trees) {
+        nodes += t->getSize();
+    }
+
+    double total = 0;
+    auto evaluating = seconds([&]() {
+        for (std::size_t e = 0; e < evaluations; ++e) {
+            for (auto t : trees) {
+                total += t->eval();
+            }
+        }
+    });
+
+    std::cout << "make:        " << nodes / making / 1e6
+              << " million nodes/s" << std::endl;
+    std::cout << "Tree::eval:  " << nodes * evaluations / evaluating / 1e6
+              << " million nodes/s (" << total << ")" << std::endl;
+
+    for (auto t : trees) {
+        delete t;
+    }
+}
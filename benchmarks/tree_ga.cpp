@@ -0,0 +1,79 @@
+/*
+ * Measures TreeGA generations per second on a scaled up version of the primes
+ * example. Built twice by 'make bench': with the node pool, and with
+ * CPPEVOLVE_NO_POOL defined so that nodes use the global allocator.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/TreeGA.hpp"
+#include <array>
+#include <chrono>
+
+using namespace evolve;
+
+const std::array<int, 10> primes = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29 };
+
+namespace nodes
+{
+    thread_local int x;
+
+    int sum(int x, int y) { return x+y; }
+    int product(int x, int y) { return x*y; }
+    int difference(int x, int y) {return x-y;}
+    int negative(int x) {return -x;}
+    int getX() { return nodes::x; }
+}
+
+double treeFitness(const tree::Tree<int>* tree)
+{
+    double total = 0;
+    std::vector<int> used;
+    for(nodes::x=0; nodes::x < static_cast<int>(primes.size()); ++nodes::x) {
+        auto val = tree->eval();
+        if (std::find(primes.begin(), primes.end(), val) != primes.end() &&
+            std::find(used.begin(), used.end(), val) == used.end()) {
+
+            used.push_back(val);
+            total += 1;
+        }
+    }
+    return total;
+}
+
+using namespace nodes;
+
+int main() {
+    const unsigned int generations = 200;
+
+    tree::TreeFactory<int> factory(7);
+    factory.addNode(sum, "sum");
+    factory.addNode(product, "product");
+    factory.addNode(difference, "difference");
+    factory.addNode(negative, "negative");
+    factory.addTerminator([]{return 5;}, "5");
+    factory.addTerminator(getX, "X");
+
+    utils::seed(1);
+    TreeGA<int, 2000> gaTree(factory, treeFitness,
+                             tree::crossover::singlePoint<int>,
+                             tree::mutator::randomNode<int>,
+                             selector::top<tree::Tree<int>*, 200>);
+    gaTree.setMutationRate(0.1f);
+
+    auto start = std::chrono::steady_clock::now();
+    gaTree.initialize();
+    for (auto i = 0U; i < generations; ++i) {
+        gaTree.step();
+    }
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+#ifdef CPPEVOLVE_NO_POOL
+    std::cout << "TreeGA, global allocator: ";
+#else
+    std::cout << "TreeGA, node pool:        ";
+#endif
+    std::cout << generations / elapsed.count() << " generations/s (best "
+              << gaTree.getBestScore() << ")" << std::endl;
+}
@@ -0,0 +1,51 @@
+/*
+ * This file serves as an example of the packed BitString genome. Each of
+ * 2000 features is either selected or not, and the fitness rewards agreeing
+ * with a hidden set of useful features. The fitness is computed a word at a
+ * time with popcount.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/BitString/Crossover.hpp"
+#include "cppEvolve/Genome/BitString/Mutator.hpp"
+#include <iostream>
+
+using namespace evolve;
+using bitstring::BitString;
+
+const std::size_t features = 2000;
+
+int main() {
+    const auto useful = BitString::random(features);
+
+    //Fitness: the number of features whose selection matches 'useful'
+    auto evaluator = bitstring::onWords(
+        [&useful](const std::uint64_t* words, std::size_t numWords,
+                  std::size_t bits) {
+            std::size_t wrong = 0;
+            for (std::size_t w = 0; w < numWords; ++w) {
+                wrong += bitstring::details::popcount(words[w] ^
+                                                      useful.data()[w]);
+            }
+            return double(bits - wrong);
+        });
+
+    SimpleGA<BitString, 100> ga(
+        []() { return BitString::random(features); },
+        evaluator,
+
+        //Crossover: each bit from either parent, a word at a time
+        bitstring::crossover::uniformInto,
+
+        //Mutation: flip each bit with probability 1/features
+        bitstring::mutator::flip(1.0 / features),
+
+        selector::top<BitString, 20>);
+
+    ga.setMutationRate(0.5f);
+    ga.run(1000);
+
+    std::cout << "Correct: " << ga.getBestScore() << " of " << features
+              << ", diversity: " << bitstring::diversity(ga.getPopulation())
+              << std::endl;
+}
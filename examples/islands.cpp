@@ -0,0 +1,44 @@
+/*
+ * This file serves as an example of the IslandModel. Four SimpleGAs evolve
+ * a list of 64 integers whose sum should be as large as possible, each on its
+ * own thread. Every 10 generations the 2 fittest members of each island are
+ * copied to the next island in a ring.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/IslandModel.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <numeric>
+
+using namespace evolve;
+using Genome = list1d::List1D<int>;
+using GA = SimpleGA<Genome, 200>;
+
+int main() {
+    IslandModel<GA> islands(4, [](unsigned int) {
+        //Each island starts from random lists of values in [0, 10)
+        auto generator = []() -> Genome {
+            Genome g(64);
+            utils::random_uints(10, g.begin(), g.end());
+            return g;
+        };
+
+        auto fitness = [](const Genome& g) -> double {
+            return std::accumulate(g.begin(), g.end(), 0);
+        };
+
+        return std::unique_ptr<GA>(
+            new GA(generator,
+                   fitness,
+                   list1d::crossover::singlePoint<Genome>,
+                   list1d::mutator::swap<Genome>,
+                   selector::top<Genome, 20>));
+    });
+
+    //Migrate the 2 best members along a ring every 10 generations
+    islands.setMigration(10, 2, Topology::RING);
+    islands.setSeed(42);
+
+    //Best possible fitness is 64 * 9 = 576
+    islands.run(200);
+}
@@ -0,0 +1,57 @@
+/*
+ * This file serves as an example of multi-objective optimization with
+ * NSGA2. Both objectives of the ZDT1 problem are minimized over 30 variables
+ * in [0, 1]. Its Pareto front is f2 = 1 - sqrt(f1) for f1 in [0, 1], reached
+ * when every variable but the first is 0.
+ */
+
+#include "cppEvolve/NSGA2.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <cmath>
+
+using namespace evolve;
+
+using Genome = list1d::List1DFixed<double, 30>;
+
+//Objectives: f1 and f2 of ZDT1
+std::array<double, 2> zdt1(const Genome& x) {
+    double g = 0;
+    for (std::size_t i = 1; i < x.size(); ++i) {
+        g += x[i];
+    }
+    g = 1 + 9 * g / (x.size() - 1);
+    return {{x[0], g * (1 - std::sqrt(x[0] / g))}};
+}
+
+int main() {
+    auto generator = []() {
+        Genome x;
+        for (auto& xi : x) {
+            xi = utils::random_real();
+        }
+        return x;
+    };
+
+    NSGA2<Genome, 2, 100> ga(
+        generator,
+        zdt1,
+
+        //Crossover: each variable from either parent
+        list1d::crossover::uniformInto<Genome>,
+
+        //Mutation: polynomial mutation of each variable with probability
+        //1/30, staying inside [0, 1]
+        list1d::mutator::polynomial<Genome>(0, 1, 20, 1.0 / 30));
+
+    ga.setMutationRate(1.0f);
+    ga.run(250, 50);
+
+    //The distance of the archive from the true front
+    double worst = 0;
+    for (const auto& solution : ga.getFront()) {
+        const auto f1 = solution.objectives[0], f2 = solution.objectives[1];
+        worst = std::max(worst, f2 - (1 - std::sqrt(f1)));
+    }
+    std::cout << ga.getFront().size() << " solutions, at most " << worst
+              << " above the Pareto front" << std::endl;
+}
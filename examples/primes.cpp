@@ -6,6 +6,7 @@
 
 #include "cppEvolve/cppEvolve.hpp"
 #include "cppEvolve/TreeGA.hpp"
+#include <array>
 
 using namespace evolve;
 
@@ -16,8 +17,9 @@ const std::array<int, 10> primes = {
 //Define functions and variables to be used in the trees
 namespace nodes
 {
-    //'x' an input to the grown function
-    int x;
+    //'x' an input to the grown function. It is thread_local so that
+    //trees may be evaluated concurrently on several threads.
+    thread_local int x;
 
     int sum(int x, int y) { return x+y; }
     int product(int x, int y) { return x*y; }
@@ -51,13 +53,17 @@ int main() {
     //Construct a Tree generator which will return trees with a max-depth of 5
     tree::TreeFactory<int> factory(5);
 
-    //Register the previous functions
-    factory.addNode(sum, "sum");
-    factory.addNode(product, "product");
-    factory.addNode(difference, "difference");
-    factory.addNode(negative, "negative");
-    factory.addTerminator([]{return 5;}, "5");
-    factory.addTerminator(getX, "X");
+    //Register the previous functions, along with the properties used to
+    //simplify the trees (see tree::NodeTraits)
+    using Traits = tree::NodeTraits<int>;
+    factory.addNode(sum, "sum", Traits().setIdentity(0).setCommutative());
+    factory.addNode(product, "product",
+                    Traits().setIdentity(1).setAbsorbing(0).setCommutative());
+    factory.addNode(difference, "difference",
+                    Traits().setIdentity(0).setSelfResult(0));
+    factory.addNode(negative, "negative", Traits());
+    factory.addTerminator([]{return 5;}, "5", Traits().setConstant());
+    factory.addTerminator(getX, "X", Traits());
 
     //Construct the algorithm
     TreeGA<int, 100> gaTree(
@@ -68,8 +74,9 @@ int main() {
         treeFitness,
 
         //Crossover: Choose a single node in one parent tree and crossover with
-        // a node from the other parent (hight will not increase)
-        tree::crossover::singlePoint<int>,
+        // a node from the other parent (hight will not increase). The child is
+        // written over a discarded tree, reusing its nodes
+        tree::crossover::singlePointInto<int>,
 
         //Mutation: Replace a random node with a new random subtree
         tree::mutator::randomNode<int>,
@@ -80,6 +87,14 @@ int main() {
     //Set mutation rate to 2%
     gaTree.setMutationRate(0.02f);
 
+    //Fold constant subtrees such as sum(5, 5) and drop no-ops such as
+    //sum(X, difference(5, 5)) before evaluating the trees
+    gaTree.setSimplification(true);
+
+    //Evaluate the population on 4 threads. treeFitness only touches the
+    //thread_local 'x', so a single evaluator may be shared by all of them
+    gaTree.setEvaluationThreads(4, ThreadSafety::SHARED);
+
     //Run and log statistics every 20 generations, should reach around 7 primes
     gaTree.run(500, 20);
 }
@@ -0,0 +1,56 @@
+/*
+ * This file serves as an example of a real valued List1D genome. The
+ * algorithm searches for the minimum of the 10 dimensional Rastrigin
+ * function, which is 0 at the origin and has many local minima.
+ */
+
+#include "cppEvolve/cppEvolve.hpp"
+#include "cppEvolve/Genome/List1D/List1D.hpp"
+#include <cmath>
+
+using namespace evolve;
+
+const double lower = -5.12, upper = 5.12;
+const double pi = 3.14159265358979323846;
+using Genome = list1d::List1DFixed<double, 10>;
+
+//Fitness: the Rastrigin function (lower is better)
+double rastrigin(const Genome& x) {
+    double total = 10 * x.size();
+    for (auto xi : x) {
+        total += xi * xi - 10 * std::cos(2 * pi * xi);
+    }
+    return total;
+}
+
+int main() {
+    //Start from points drawn uniformly from the domain
+    auto generator = []() {
+        Genome x;
+        for (auto& xi : x) {
+            xi = lower + utils::random_real() * (upper - lower);
+        }
+        return x;
+    };
+
+    SimpleGA<Genome, 200> ga(
+        generator,
+        rastrigin,
+
+        //Crossover: draw each coordinate around those of the parents
+        //(BLX-0.5), writing into a discarded genome
+        list1d::crossover::blendInto<Genome>(0.5),
+
+        //Mutation: polynomial mutation of each coordinate with
+        //probability 1/10, staying inside the domain
+        list1d::mutator::polynomial<Genome>(lower, upper, 20, 0.1),
+
+        //Keep the 20 lowest points each generation
+        selector::top<Genome, 20, Ordering::LOWER>);
+
+    ga.setOrdering(Ordering::LOWER);
+    ga.setMutationRate(0.5f);
+
+    //Should come close to the minimum of 0
+    ga.run(500, 100);
+}
@@ -25,20 +25,47 @@ const std::map<const std::array<char, 2>, unsigned int> distances{
 //A genome is an ordering of these cities
 using Genome = List1DFixed<char, 4>;
 
+//The distance between two cities
+double distance(char a, char b) {
+    return (a < b) ? distances.at({a, b}) : distances.at({b, a});
+}
+
 //Fitness: Minimize the distance along the path
 double fitness(const Genome& ind) {
     double total = 0;
     for(auto i= 0U; i < ind.size()-1; ++i) {
-        if (ind[i] < ind[i+1]) {
-            total += distances.at({ind[i], ind[i+1]});
-        }
-        else {
-            total += distances.at({ind[i+1], ind[i]});
-        }
+        total += distance(ind[i], ind[i+1]);
+    }
+    return total;
+}
+
+//The length of the edges leaving positions first-1, first, second-1 and
+//second of a path in which the cities at 'first' and 'second' are 'a' and 'b'
+double edgesAround(const Genome& ind, const Change& change, char a, char b) {
+    auto city = [&](std::size_t i) {
+        return (i == change.first) ? a : (i == change.second) ? b : ind[i];
+    };
+    const std::size_t edges[] = {change.first - 1, change.first,
+                                 change.second - 1, change.second};
+    double total = 0;
+    for (auto k = 0U; k < 4; ++k) {
+        //Skip edges off the ends of the path (first - 1 wraps around when
+        //first is 0). When the positions are adjacent, the edge between them
+        //is listed twice (first <= second); count it once.
+        if (edges[k] >= ind.size() - 1 || (k == 2 && edges[2] == edges[1]))
+            continue;
+        total += distance(city(edges[k]), city(edges[k] + 1));
     }
     return total;
 }
 
+//Delta fitness: after a swap only the edges next to the two positions change
+double swapFitness(const Genome& ind, const Change& change, double before) {
+    const auto a = ind[change.first], b = ind[change.second];
+    return before - edgesAround(ind, change, b, a) +
+        edgesAround(ind, change, a, b);
+}
+
 int main()
 {
     //All members of the population start with route A->B->C->D
@@ -61,6 +88,20 @@ int main()
         //(smaller distance is better)
         selector::top<Genome, 5, Ordering::LOWER>);
 
+    //The GA must also know that lower fitness is better to track the best path
+    gaList.setOrdering(Ordering::LOWER);
+
+    //Swap mutations update the fitness from the four edges they touch
+    //instead of measuring the whole path again
+    gaList.setDeltaMutator(list1d::mutator::deltaSwap<Genome>, swapFitness);
+
+    //Most children are copies of a parent, so remember the fitness of the
+    //last 1000 distinct paths rather than measuring them again
+    gaList.setFitnessCache(1000);
+
     //Evolve for 100 generations, converges on "acbd" or "dbca"
     gaList.run(100);
+
+    std::cout << "Fitness cache hit rate: "
+              << gaList.getFitnessCache()->getHitRate() << std::endl;
 }
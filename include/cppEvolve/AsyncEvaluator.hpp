@@ -0,0 +1,218 @@
+#ifndef ASYNCEVALUATOR_H_
+#define ASYNCEVALUATOR_H_
+
+#include "cppEvolve/ParallelEvaluator.hpp"
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace evolve {
+namespace utils {
+
+/*!
+ * A first in, first out queue shared between threads. push blocks while the
+ * queue holds 'capacity' items and pop blocks while it is empty, until the
+ * queue is closed.
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(
+        std::size_t _capacity = std::numeric_limits<std::size_t>::max())
+        : capacity(std::max<std::size_t>(1, _capacity)) {}
+
+    /// Add 'item', waiting for space. Returns false if the queue is closed.
+    bool push(T&& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&]() { return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /*!
+     * Take the oldest item, waiting for one. Returns false if the queue is
+     * closed and empty.
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&]() { return closed || !items.empty(); });
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /// Take the oldest item if there is one
+    bool tryPop(T& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty())
+            return false;
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /// Wake every waiting thread. Items already queued may still be popped.
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+    std::size_t getCapacity() const { return capacity; }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notFull, notEmpty;
+    std::deque<T> items;
+    std::size_t capacity;
+    bool closed = false;
+};
+}
+
+/*!
+ * Evaluates genomes on worker threads without waiting for them. Genomes
+ * given to submit are queued for the workers, and their fitness is
+ * returned by collect in the order the evaluations finish, so a slow
+ * evaluation holds up nothing but its own result. At most 'capacity'
+ * genomes wait in the queue; submit blocks while it is full, which bounds
+ * the work in flight to capacity plus one per worker.
+ *
+ * The evaluator runs on the workers only. It may itself wait on something
+ * external, such as a simulation in a subprocess.
+ */
+template <typename Genome, typename Evaluator>
+class AsyncEvaluator {
+public:
+    /// A genome with its fitness
+    struct Result {
+        Genome genome;
+        double fitness;
+    };
+
+    /*!
+     * @param evaluator The fitness function
+     * @param workers The number of threads to use (0 for one per core)
+     * @param capacity The number of genomes which may wait for a worker (0
+     * for one per worker)
+     * @param safety Whether the workers share 'evaluator' or copy it
+     */
+    AsyncEvaluator(const Evaluator& evaluator, unsigned int workers = 0,
+                   std::size_t capacity = 0,
+                   ThreadSafety safety = ThreadSafety::SHARED)
+        : jobs(capacity != 0 ? capacity
+                             : (workers != 0
+                                    ? workers
+                                    : std::thread::hardware_concurrency())) {
+        if (workers == 0) {
+            workers = std::max(1U, std::thread::hardware_concurrency());
+        }
+        auto copies = (safety == ThreadSafety::PER_THREAD) ? workers : 1;
+        evaluators.reserve(copies);
+        while (evaluators.size() < copies) {
+            evaluators.push_back(evaluator);
+        }
+        for (auto id = 0U; id < workers; ++id) {
+            threads.emplace_back([this, id]() { workerLoop(id); });
+        }
+    }
+
+    AsyncEvaluator(const AsyncEvaluator&) = delete;
+    AsyncEvaluator& operator=(const AsyncEvaluator&) = delete;
+
+    /// Stops the workers once their current evaluations finish. Queued
+    /// genomes are not evaluated.
+    ~AsyncEvaluator() {
+        jobs.close();
+        results.close();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// Queue 'genome' for evaluation, waiting while the queue is full
+    void submit(Genome&& genome) {
+        ++pending;
+        jobs.push(Outcome{std::move(genome), 0, nullptr});
+    }
+
+    /*!
+     * Wait for an evaluation to finish and return it. If the evaluator threw,
+     * the exception is rethrown here. There must be an evaluation pending.
+     */
+    Result collect() {
+        assert(pending > 0);
+        Outcome outcome;
+        results.pop(outcome);
+        return finish(outcome);
+    }
+
+    /// Take a finished evaluation if there is one, without waiting
+    bool tryCollect(Result& result) {
+        Outcome outcome;
+        if (!results.tryPop(outcome))
+            return false;
+        result = finish(outcome);
+        return true;
+    }
+
+    /// The number of genomes submitted and not yet collected
+    std::size_t getPending() const { return pending; }
+
+    /// The number of genomes which may wait in the queue
+    std::size_t getCapacity() const { return jobs.getCapacity(); }
+
+    unsigned int getWorkers() const { return threads.size(); }
+
+private:
+    struct Outcome {
+        Genome genome;
+        double fitness;
+        std::exception_ptr error;
+    };
+
+    void workerLoop(unsigned int id) {
+        const auto& evaluator = evaluators[std::min<std::size_t>(
+            id, evaluators.size() - 1)];
+        Outcome outcome;
+        while (jobs.pop(outcome)) {
+            try {
+                outcome.fitness = evaluator(outcome.genome);
+            } catch (...) {
+                outcome.error = std::current_exception();
+            }
+            if (!results.push(std::move(outcome)))
+                return;
+        }
+    }
+
+    Result finish(Outcome& outcome) {
+        --pending;
+        if (outcome.error)
+            std::rethrow_exception(outcome.error);
+        return Result{std::move(outcome.genome), outcome.fitness};
+    }
+
+    utils::BoundedQueue<Outcome> jobs;
+    utils::BoundedQueue<Outcome> results; // unbounded, so workers never wait
+    std::vector<Evaluator> evaluators;
+    std::vector<std::thread> threads;
+    std::size_t pending = 0;
+};
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef FITNESSCACHE_H_
+#define FITNESSCACHE_H_
+
+#include "cppEvolve/utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace evolve {
+
+/*!
+ * The 64 bit hash of a genome used as the key of a FitnessCache. Genomes with
+ * a hash() member, such as tree::FlatTree and bitstring::BitString, use it,
+ * as do genomes held by pointer, such as tree::Tree<T>*. Lists (std::array,
+ * std::vector, ...) hash their alleles with std::hash.
+ */
+template <typename Genome>
+struct GenomeHash {
+    std::uint64_t operator()(const Genome& genome) const {
+        return hash(genome, typename utils::has_hash<Genome>::type{});
+    }
+
+private:
+    static std::uint64_t hash(const Genome& genome, std::true_type) {
+        return genome.hash();
+    }
+
+    static std::uint64_t hash(const Genome& genome, std::false_type) {
+        using Allele = typename std::decay<decltype(*genome.begin())>::type;
+        std::uint64_t result = genome.size();
+        for (const auto& allele : genome) {
+            result = utils::hashCombine(result, std::hash<Allele>()(allele));
+        }
+        return result;
+    }
+};
+
+template <typename T>
+struct GenomeHash<T*> {
+    std::uint64_t operator()(const T* genome) const { return genome->hash(); }
+};
+
+/*!
+ * A bounded map from genome hashes to fitness, so that genomes which survive
+ * selection or are copied from a parent are not scored again. Only the hash
+ * is stored: two genomes with the same 64 bit hash are taken to be equal,
+ * and the evaluator must be deterministic.
+ *
+ * The entries are divided among stripes, each with its own lock, so the
+ * cache may be shared by the threads of a ParallelEvaluator. When a stripe is
+ * full, an entry is evicted with the clock algorithm: entries found since
+ * the hand last passed them are given a second chance.
+ */
+template <typename Genome, typename Hash = GenomeHash<Genome>>
+class FitnessCache {
+public:
+    /*!
+     * @param capacity The number of fitness values kept
+     * @param stripes The number of independently locked parts of the cache
+     */
+    explicit FitnessCache(std::size_t capacity, std::size_t stripes = 16)
+        : parts(std::max<std::size_t>(1, std::min(stripes, capacity))) {
+        for (auto& part : parts) {
+            part.capacity = std::max<std::size_t>(1, capacity / parts.size());
+        }
+    }
+
+    /// Look up the fitness of a genome with hash 'key'
+    bool find(std::uint64_t key, double& fitness) {
+        auto& part = stripe(key);
+        std::lock_guard<std::mutex> lock(part.mutex);
+        auto entry = part.index.find(key);
+        if (entry == part.index.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto& slot = part.slots[entry->second];
+        slot.referenced = true;
+        fitness = slot.fitness;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Record the fitness of a genome with hash 'key'
+    void insert(std::uint64_t key, double fitness) {
+        auto& part = stripe(key);
+        std::lock_guard<std::mutex> lock(part.mutex);
+        auto entry = part.index.find(key);
+        if (entry != part.index.end()) {
+            part.slots[entry->second].fitness = fitness;
+            return;
+        }
+
+        if (part.slots.size() < part.capacity) {
+            part.index.emplace(key, part.slots.size());
+            part.slots.push_back(Slot{key, fitness, false});
+            return;
+        }
+
+        while (part.slots[part.hand].referenced) {
+            part.slots[part.hand].referenced = false;
+            part.hand = (part.hand + 1) % part.slots.size();
+        }
+        auto& victim = part.slots[part.hand];
+        part.index.erase(victim.key);
+        part.index.emplace(key, part.hand);
+        victim = Slot{key, fitness, false};
+        part.hand = (part.hand + 1) % part.slots.size();
+    }
+
+    /// The fitness of 'genome', computed with 'evaluator' unless cached
+    template <typename Evaluator>
+    double evaluate(const Genome& genome, const Evaluator& evaluator) {
+        const auto key = hash(genome);
+        double fitness;
+        if (!find(key, fitness)) {
+            fitness = evaluator(genome);
+            insert(key, fitness);
+        }
+        return fitness;
+    }
+
+    /// Remove every entry and reset the counters
+    void clear() {
+        for (auto& part : parts) {
+            std::lock_guard<std::mutex> lock(part.mutex);
+            part.slots.clear();
+            part.index.clear();
+            part.hand = 0;
+        }
+        hits = 0;
+        misses = 0;
+    }
+
+    std::uint64_t getHits() const { return hits; }
+
+    std::uint64_t getMisses() const { return misses; }
+
+    /// The fraction of lookups which found a cached fitness
+    double getHitRate() const {
+        const double total = getHits() + getMisses();
+        return total > 0 ? getHits() / total : 0;
+    }
+
+private:
+    struct Slot {
+        std::uint64_t key;
+        double fitness;
+        bool referenced;
+    };
+
+    struct Stripe {
+        std::mutex mutex;
+        std::vector<Slot> slots;
+        std::unordered_map<std::uint64_t, std::size_t> index;
+        std::size_t capacity = 0;
+        std::size_t hand = 0;
+    };
+
+    Stripe& stripe(std::uint64_t key) {
+        return parts[(key >> 32) % parts.size()];
+    }
+
+    Hash hash;
+    std::vector<Stripe> parts;
+    std::atomic<std::uint64_t> hits{0}, misses{0};
+};
+
+/*!
+ * An evaluator which consults a FitnessCache before calling 'evaluator'.
+ * Copies share the cache.
+ */
+template <typename Genome, typename Evaluator,
+          typename Hash = GenomeHash<Genome>>
+struct CachedEvaluator {
+    double operator()(const Genome& genome) const {
+        return cache->evaluate(genome, evaluator);
+    }
+
+    Evaluator evaluator;
+    std::shared_ptr<FitnessCache<Genome, Hash>> cache;
+};
+}
+
+#endif
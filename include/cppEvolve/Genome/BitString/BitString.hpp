@@ -0,0 +1,266 @@
+#ifndef BITSTRING_H_
+#define BITSTRING_H_
+
+#include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+namespace evolve {
+
+/*!
+ * Defines a packed string of bits genome for problems with many boolean genes
+ * (e.g. feature selection). Its crossovers and mutators are in Crossover.hpp
+ * and Mutator.hpp.
+ */
+namespace bitstring {
+
+namespace details {
+
+inline unsigned int popcount(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) +
+           ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (word * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+// The bits of a word below position 'bit'
+inline std::uint64_t lowMask(std::size_t bit) {
+    return (bit % 64 == 0) ? 0 : ~std::uint64_t(0) >> (64 - bit % 64);
+}
+}
+
+/*!
+ * A string of bits packed 64 to a word. Bits past the end of the last word
+ * are always zero, so whole words may be compared, counted and combined.
+ * Iteration yields the bits as bools.
+ */
+class BitString {
+public:
+    using value_type = bool;
+
+    /// Iterates over the bits, least significant bit of the first word first
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = bool;
+
+        const_iterator(const BitString* _bits, std::size_t _index)
+            : bits(_bits), index(_index) {}
+
+        bool operator*() const { return (*bits)[index]; }
+        bool operator[](difference_type n) const { return (*bits)[index + n]; }
+
+        const_iterator& operator++() {
+            ++index;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto previous = *this;
+            ++index;
+            return previous;
+        }
+        const_iterator& operator--() {
+            --index;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto previous = *this;
+            --index;
+            return previous;
+        }
+        const_iterator& operator+=(difference_type n) {
+            index += n;
+            return *this;
+        }
+        const_iterator& operator-=(difference_type n) {
+            index -= n;
+            return *this;
+        }
+        const_iterator operator+(difference_type n) const {
+            return const_iterator(bits, index + n);
+        }
+        friend const_iterator operator+(difference_type n,
+                                        const const_iterator& it) {
+            return it + n;
+        }
+        const_iterator operator-(difference_type n) const {
+            return const_iterator(bits, index - n);
+        }
+        difference_type operator-(const const_iterator& other) const {
+            return index - other.index;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return index == other.index;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return index != other.index;
+        }
+        bool operator<(const const_iterator& other) const {
+            return index < other.index;
+        }
+        bool operator>(const const_iterator& other) const {
+            return index > other.index;
+        }
+        bool operator<=(const const_iterator& other) const {
+            return index <= other.index;
+        }
+        bool operator>=(const const_iterator& other) const {
+            return index >= other.index;
+        }
+
+    private:
+        const BitString* bits;
+        std::size_t index;
+    };
+
+    explicit BitString(std::size_t _bits = 0, bool value = false)
+        : bits(_bits), words((_bits + 63) / 64, value ? ~std::uint64_t(0) : 0) {
+        clearTail();
+    }
+
+    /// A string of 'bits' bits, each set with probability 'p'
+    static BitString random(std::size_t bits, double p = 0.5) {
+        BitString result(bits);
+        if (p == 0.5) {
+            for (auto& word : result.words) {
+                word = utils::random_bits();
+            }
+        } else {
+            for (std::size_t i = 0; i < bits; ++i) {
+                result.set(i, utils::random_real() < p);
+            }
+        }
+        result.clearTail();
+        return result;
+    }
+
+    /// The number of bits
+    std::size_t size() const { return bits; }
+
+    bool operator[](std::size_t i) const {
+        return (words[i / 64] >> (i % 64)) & 1;
+    }
+
+    void set(std::size_t i, bool value = true) {
+        const auto bit = std::uint64_t(1) << (i % 64);
+        words[i / 64] = value ? (words[i / 64] | bit) : (words[i / 64] & ~bit);
+    }
+
+    void flip(std::size_t i) { words[i / 64] ^= std::uint64_t(1) << (i % 64); }
+
+    /// The number of set bits
+    std::size_t count() const {
+        std::size_t total = 0;
+        for (auto word : words) {
+            total += details::popcount(word);
+        }
+        return total;
+    }
+
+    /// The packed words, with bit i in bit i % 64 of word i / 64
+    const std::uint64_t* data() const { return words.data(); }
+
+    /// The packed words. Bits past size() must be left zero.
+    std::uint64_t* data() { return words.data(); }
+
+    std::size_t numWords() const { return words.size(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, bits); }
+
+    bool operator==(const BitString& other) const {
+        return bits == other.bits && words == other.words;
+    }
+
+    bool operator!=(const BitString& other) const { return !(*this == other); }
+
+    /// A hash of the bits, for FitnessCache
+    std::uint64_t hash() const {
+        std::uint64_t hash = bits;
+        for (auto word : words) {
+            hash = utils::hashCombine(hash, word);
+        }
+        return hash;
+    }
+
+    /// Resize to 'other's number of bits, reusing the storage held
+    void resizeLike(const BitString& other) {
+        bits = other.bits;
+        words.resize(other.words.size());
+    }
+
+    /// Zero the bits of the last word past size()
+    void clearTail() {
+        if (!words.empty() && bits % 64 != 0)
+            words.back() &= details::lowMask(bits);
+    }
+
+private:
+    std::size_t bits;
+    std::vector<std::uint64_t> words;
+};
+
+inline std::ostream& operator<<(std::ostream& out, const BitString& bits) {
+    for (auto bit : bits) {
+        out << (bit ? '1' : '0');
+    }
+    return out;
+}
+
+/// The number of bits in which 'a' and 'b' differ
+inline std::size_t hamming(const BitString& a, const BitString& b) {
+    const auto common = std::min(a.numWords(), b.numWords());
+    std::size_t total = 0;
+    for (std::size_t w = 0; w < common; ++w) {
+        total += details::popcount(a.data()[w] ^ b.data()[w]);
+    }
+    return total;
+}
+
+/*!
+ * The mean Hamming distance between pairs of members of 'population', a
+ * measure of its diversity. Takes O(n^2) popcounts of words.
+ */
+inline double diversity(const Population<BitString>& population) {
+    const auto n = population.size();
+    if (n < 2)
+        return 0;
+    double total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            total += hamming(population[i].genome, population[j].genome);
+        }
+    }
+    return total / (n * (n - 1) / 2);
+}
+
+/*!
+ * Adapt a fitness function taking the packed words, the number of words and
+ * the number of bits into an evaluator of BitStrings, e.g. to count the set
+ * bits of a mask with popcount.
+ */
+template <typename F>
+std::function<double(const BitString&)> onWords(F f) {
+    return [f](const BitString& bits) {
+        return f(bits.data(), bits.numWords(), bits.size());
+    };
+}
+}
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef BITSTRING_CROSSOVER_H_
+#define BITSTRING_CROSSOVER_H_
+
+#include "cppEvolve/Genome/BitString/BitString.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace evolve {
+namespace bitstring {
+
+/*!
+ * Contains crossover functions for BitStrings, which combine the parents a
+ * word at a time through masks. Each has an Into form writing the child
+ * into 'g', reusing its storage.
+ */
+namespace crossover {
+namespace details {
+
+// Copy the bits [first, last) of 'source' into 'target'
+inline void copyBits(const BitString& source, BitString& target,
+                     std::size_t first, std::size_t last) {
+    if (first >= last)
+        return;
+    const auto from = source.data();
+    auto to = target.data();
+    const auto firstWord = first / 64, lastWord = (last - 1) / 64;
+    for (auto w = firstWord; w <= lastWord; ++w) {
+        auto mask = ~std::uint64_t(0);
+        if (w == firstWord)
+            mask &= ~bitstring::details::lowMask(first);
+        if (w == lastWord && last % 64 != 0)
+            mask &= bitstring::details::lowMask(last);
+        to[w] = (to[w] & ~mask) | (from[w] & mask);
+    }
+}
+}
+
+/// The bits of g1 before a random point, then the bits of g2
+inline void singlePointInto(const BitString& g1, const BitString& g2,
+                            BitString& g) {
+    g = g1;
+    const auto size = std::min(g1.size(), g2.size());
+    details::copyBits(g2, g, utils::random_uint(size + 1), size);
+}
+
+inline BitString singlePoint(const BitString& g1, const BitString& g2) {
+    BitString g;
+    singlePointInto(g1, g2, g);
+    return g;
+}
+
+/// The bits of g1, with those between two random points taken from g2
+inline void twoPointInto(const BitString& g1, const BitString& g2,
+                         BitString& g) {
+    g = g1;
+    const auto size = std::min(g1.size(), g2.size());
+    auto first = utils::random_uint(size + 1);
+    auto last = utils::random_uint(size + 1);
+    if (last < first)
+        std::swap(first, last);
+    details::copyBits(g2, g, first, last);
+}
+
+inline BitString twoPoint(const BitString& g1, const BitString& g2) {
+    BitString g;
+    twoPointInto(g1, g2, g);
+    return g;
+}
+
+/// Each bit from either parent with equal probability, one random mask per
+/// word
+inline void uniformInto(const BitString& g1, const BitString& g2,
+                        BitString& g) {
+    g.resizeLike(g1);
+    const auto common = std::min(g1.numWords(), g2.numWords());
+    auto out = g.data();
+    for (std::size_t w = 0; w < common; ++w) {
+        const auto mask = utils::random_bits();
+        out[w] = (g1.data()[w] & ~mask) | (g2.data()[w] & mask);
+    }
+    std::copy(g1.data() + common, g1.data() + g1.numWords(), out + common);
+    g.clearTail();
+}
+
+inline BitString uniform(const BitString& g1, const BitString& g2) {
+    BitString g;
+    uniformInto(g1, g2, g);
+    return g;
+}
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef BITSTRING_MUTATORS_H_
+#define BITSTRING_MUTATORS_H_
+
+#include "cppEvolve/Genome/BitString/BitString.hpp"
+
+#include <functional>
+
+namespace evolve {
+namespace bitstring {
+
+/*!
+ * Contains mutators for BitStrings
+ */
+namespace mutator {
+
+/// Flip a single random bit
+inline void flipOne(BitString& g) {
+    if (g.size() > 0)
+        g.flip(utils::random_uint(g.size()));
+}
+
+/*!
+ * Returns a mutator flipping each bit with probability 'probability'. The
+ * gaps between flipped bits are drawn geometrically, so the cost is
+ * proportional to the number of bits flipped.
+ */
+inline std::function<void(BitString&)> flip(double probability) {
+    return [probability](BitString& g) {
+        if (probability >= 1) {
+            for (std::size_t w = 0; w < g.numWords(); ++w) {
+                g.data()[w] = ~g.data()[w];
+            }
+            g.clearTail();
+            return;
+        }
+        if (probability <= 0)
+            return;
+        utils::GeometricSkip skip(probability);
+        for (auto i = skip(); i < g.size(); i += 1 + skip()) {
+            g.flip(i);
+        }
+    };
+}
+}
+}
+}
+
+#endif
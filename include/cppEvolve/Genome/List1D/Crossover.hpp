@@ -6,6 +6,8 @@
 
 #include <cstdlib>
 #include <algorithm>
+#include <array>
+#include <functional>
 
 namespace evolve {
 namespace list1d {
@@ -17,9 +19,8 @@ namespace crossover {
 namespace details {
 
 template <typename Genome>
-Genome singlePointHelper(const Genome& g1, const Genome& g2, std::false_type) {
-    Genome g;
-
+void singlePointIntoHelper(const Genome& g1, const Genome& g2, Genome& g,
+                           std::false_type) {
     auto size = std::min(g1.size(), g2.size());
     auto location = utils::random_uint(size);
 
@@ -29,14 +30,11 @@ Genome singlePointHelper(const Genome& g1, const Genome& g2, std::false_type) {
         else
             g[i] = g2[i];
     }
-
-    return g;
 }
 
 template <typename Genome>
-Genome singlePointHelper(const Genome& g1, const Genome& g2, std::true_type) {
-    Genome g;
-
+void singlePointIntoHelper(const Genome& g1, const Genome& g2, Genome& g,
+                           std::true_type) {
     auto size = std::min(g1.size(), g2.size());
     auto location = utils::random_uint(size);
 
@@ -46,9 +44,11 @@ Genome singlePointHelper(const Genome& g1, const Genome& g2, std::true_type) {
     std::advance(g1location, location);
     std::advance(g2location, location);
 
-    g.insert(g.begin(), g1.begin(), g1location);
+    // assign and insert reuse the storage already held by g, which only
+    // needs to grow once
+    utils::reserve(g, location + std::distance(g2location, g2.end()));
+    g.assign(g1.begin(), g1location);
     g.insert(g.end(), g2location, g2.end());
-    return g;
 }
 
 } // end detail namespace
@@ -58,11 +58,151 @@ Genome singlePointHelper(const Genome& g1, const Genome& g2, std::true_type) {
  * elements before the point on one Genome, and the alleles after the point
  * on the other Genome. This crossover function preserves the number of
  * alleles in the Genome.
+ *
+ * Each crossover has an Into form, which writes the child into 'g' reusing
+ * its storage, and a form returning a new Genome.
  */
 template <typename Genome>
-Genome singlePoint(const Genome& g1, const Genome& g2) {
+void singlePointInto(const Genome& g1, const Genome& g2, Genome& g) {
     using has_range_insert_t = typename utils::has_range_insert<Genome>::type;
-    return details::singlePointHelper(g1, g2, has_range_insert_t{});
+    details::singlePointIntoHelper(g1, g2, g, has_range_insert_t{});
+}
+
+template <typename Genome>
+Genome singlePoint(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    singlePointInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Selects K random points. The child takes the alleles of g1 up to the
+ * first point, of g2 up to the second, and so on alternately. The genomes
+ * must allow random access; the child has the size of g1.
+ */
+template <typename Genome, unsigned int K>
+void kPointInto(const Genome& g1, const Genome& g2, Genome& g) {
+    g = g1; // Reuses the storage of 'g'
+    const auto size = std::min(g1.size(), g2.size());
+
+    std::array<std::size_t, K> points;
+    utils::random_uints(size + 1, points.begin(), points.end());
+    std::sort(points.begin(), points.end());
+
+    for (unsigned int k = 0; k < K; k += 2) {
+        const auto last = (k + 1 < K) ? points[k + 1] : size;
+        std::copy(g2.begin() + points[k], g2.begin() + last,
+                  g.begin() + points[k]);
+    }
+}
+
+template <typename Genome, unsigned int K>
+Genome kPoint(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    kPointInto<Genome, K>(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Two point crossover: the child is g1 with the alleles between two random
+ * points taken from g2.
+ */
+template <typename Genome>
+void twoPointInto(const Genome& g1, const Genome& g2, Genome& g) {
+    kPointInto<Genome, 2>(g1, g2, g);
+}
+
+template <typename Genome>
+Genome twoPoint(const Genome& g1, const Genome& g2) {
+    return kPoint<Genome, 2>(g1, g2);
+}
+
+/*!
+ * Uniform crossover: each allele is taken from either parent with equal
+ * probability. The choices come from the bits of one random number per 64
+ * alleles and the selection is branch free, so for arithmetic alleles the
+ * loop may be vectorized.
+ */
+template <typename Genome>
+void uniformInto(const Genome& g1, const Genome& g2, Genome& g) {
+    utils::resizeLike(g, g1);
+    const auto size = std::min(g1.size(), g2.size());
+
+    for (std::size_t first = 0; first < size; first += 64) {
+        auto bits = utils::random_bits();
+        const auto last = std::min<std::size_t>(first + 64, size);
+        for (auto i = first; i < last; ++i, bits >>= 1) {
+            g[i] = (bits & 1) ? g2[i] : g1[i];
+        }
+    }
+    std::copy(g1.begin() + size, g1.end(), g.begin() + size);
+}
+
+template <typename Genome>
+Genome uniform(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    uniformInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Arithmetic crossover for numeric genomes: the child is w * g1 +
+ * (1 - w) * g2 for a random weight w in [0, 1).
+ */
+template <typename Genome>
+void arithmeticInto(const Genome& g1, const Genome& g2, Genome& g) {
+    using Allele = typename Genome::value_type;
+    utils::resizeLike(g, g1);
+    const auto size = std::min(g1.size(), g2.size());
+    const auto w = utils::random_real();
+
+    for (std::size_t i = 0; i < size; ++i) {
+        g[i] = static_cast<Allele>(w * g1[i] + (1 - w) * g2[i]);
+    }
+    std::copy(g1.begin() + size, g1.end(), g.begin() + size);
+}
+
+template <typename Genome>
+Genome arithmetic(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    arithmeticInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Blend crossover (BLX-alpha) for numeric genomes: each allele is drawn
+ * uniformly from the interval spanned by the parents' alleles, widened by
+ * 'alpha' times its length on both sides. Returns the crossover function,
+ * e.g. list1d::crossover::blendInto<Genome>(0.5).
+ */
+template <typename Genome>
+std::function<void(const Genome&, const Genome&, Genome&)> blendInto(
+    double alpha = 0.5) {
+    return [alpha](const Genome& g1, const Genome& g2, Genome& g) {
+        using Allele = typename Genome::value_type;
+        utils::resizeLike(g, g1);
+        const auto size = std::min(g1.size(), g2.size());
+
+        for (std::size_t i = 0; i < size; ++i) {
+            const double low = std::min(g1[i], g2[i]);
+            const double width = std::max(g1[i], g2[i]) - low;
+            g[i] = static_cast<Allele>(low - alpha * width +
+                                       utils::random_real() *
+                                           (1 + 2 * alpha) * width);
+        }
+        std::copy(g1.begin() + size, g1.end(), g.begin() + size);
+    };
+}
+
+template <typename Genome>
+std::function<Genome(const Genome&, const Genome&)> blend(
+    double alpha = 0.5) {
+    auto into = blendInto<Genome>(alpha);
+    return [into](const Genome& g1, const Genome& g2) {
+        Genome g{};
+        into(g1, g2, g);
+        return g;
+    };
 }
 
 /*!
@@ -75,6 +215,14 @@ Genome randomCopy(const Genome& g1, const Genome& g2) {
     }
     return g2;
 }
+
+/*!
+ * As randomCopy, but the copy is written into 'g', reusing its storage.
+ */
+template <typename Genome>
+void randomCopyInto(const Genome& g1, const Genome& g2, Genome& g) {
+    g = utils::random_uint(2) ? g1 : g2;
+}
 }
 }
 }
@@ -4,6 +4,10 @@
 
 #include "Crossover.hpp"
 #include "Mutator.hpp"
+#include "Permutation.hpp"
+
+#include <array>
+#include <vector>
 
 namespace evolve {
 
@@ -4,6 +4,12 @@
 
 #include "cppEvolve/utils.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
 namespace evolve {
 namespace list1d {
 
@@ -11,6 +17,36 @@ namespace list1d {
  *  Contains built-in mutators for list-like genomes
  */
 namespace mutator {
+namespace details {
+
+// Call f(i) for each position i < size selected with 'probability'. Below
+// a probability of 1 the gaps between selected positions are drawn, rather
+// than a number per position.
+template <typename F>
+void forSelected(std::size_t size, double probability, const F& f) {
+    if (probability >= 1) {
+        for (std::size_t i = 0; i < size; ++i) {
+            f(i);
+        }
+    } else if (probability > 0) {
+        utils::GeometricSkip skip(probability);
+        for (auto i = skip(); i < size; i += 1 + skip()) {
+            f(i);
+        }
+    }
+}
+
+inline std::vector<double>& noise(std::size_t size) {
+    thread_local std::vector<double> values;
+    values.resize(std::max(values.size(), size));
+    return values;
+}
+
+template <typename T>
+T clamp(double value, double lower, double upper) {
+    return static_cast<T>(std::min(std::max(value, lower), upper));
+}
+}
 
 /*!
  *  Swaps two random alleles in the given Genome
@@ -28,6 +64,110 @@ void swap(Genome& g) {
 
     std::swap(*s1location, *s2location);
 }
+
+/*!
+ * As swap, but reports the positions exchanged (first <= second) for use
+ * with a delta evaluator (see SimpleGA::setDeltaMutator)
+ */
+template <typename Genome>
+Change deltaSwap(Genome& g) {
+    std::size_t s1 = utils::random_uint(g.size());
+    std::size_t s2 = utils::random_uint(g.size());
+    if (s1 == s2)
+        return Change{Change::NONE, s1, s2};
+    if (s2 < s1)
+        std::swap(s1, s2);
+
+    auto s1location = begin(g);
+    auto s2location = begin(g);
+
+    std::advance(s1location, s1);
+    std::advance(s2location, s2);
+
+    std::swap(*s1location, *s2location);
+    return Change{Change::SWAP, s1, s2};
+}
+
+/*!
+ * Returns a mutator for numeric genomes (e.g. List1D<double>) which adds
+ * normally distributed noise with deviation 'sigma' to each allele with
+ * probability 'probability', clamping the result to [lower, upper]. When
+ * every allele is mutated, the noise is drawn in one batch and added in a
+ * loop the compiler may vectorize.
+ */
+template <typename Genome>
+std::function<void(Genome&)> gaussian(
+    double sigma, double probability = 1,
+    double lower = std::numeric_limits<double>::lowest(),
+    double upper = std::numeric_limits<double>::max()) {
+    return [=](Genome& g) {
+        using Allele = typename Genome::value_type;
+        if (probability < 1) {
+            details::forSelected(g.size(), probability, [&](std::size_t i) {
+                g[i] = details::clamp<Allele>(
+                    g[i] + sigma * utils::random_normal(), lower, upper);
+            });
+            return;
+        }
+
+        auto& noise = details::noise(g.size());
+        utils::random_normals(noise.begin(), noise.begin() + g.size());
+        for (std::size_t i = 0; i < g.size(); ++i) {
+            g[i] = details::clamp<Allele>(g[i] + sigma * noise[i], lower,
+                                          upper);
+        }
+    };
+}
+
+/*!
+ * Returns a mutator which replaces each allele, with probability
+ * 'probability', by a number drawn uniformly from [lower, upper).
+ */
+template <typename Genome>
+std::function<void(Genome&)> uniformReset(double lower, double upper,
+                                          double probability) {
+    return [=](Genome& g) {
+        using Allele = typename Genome::value_type;
+        details::forSelected(g.size(), probability, [&](std::size_t i) {
+            g[i] = static_cast<Allele>(lower +
+                                       utils::random_real() * (upper - lower));
+        });
+    };
+}
+
+/*!
+ * Returns Deb's polynomial mutation for alleles bounded by [lower, upper],
+ * as used with simulated binary crossover. Each allele is mutated with
+ * probability 'probability'; larger values of the distribution index 'eta'
+ * keep the mutated allele closer to the original.
+ */
+template <typename Genome>
+std::function<void(Genome&)> polynomial(double lower, double upper,
+                                        double eta = 20,
+                                        double probability = 1) {
+    return [=](Genome& g) {
+        using Allele = typename Genome::value_type;
+        const auto width = upper - lower;
+        const auto power = 1 / (eta + 1);
+        details::forSelected(g.size(), probability, [&](std::size_t i) {
+            const double y = g[i];
+            const auto r = utils::random_real();
+            double delta;
+            if (r < 0.5) {
+                const auto xy = 1 - (y - lower) / width;
+                const auto value =
+                    2 * r + (1 - 2 * r) * std::pow(xy, eta + 1);
+                delta = std::pow(value, power) - 1;
+            } else {
+                const auto xy = 1 - (upper - y) / width;
+                const auto value =
+                    2 * (1 - r) + 2 * (r - 0.5) * std::pow(xy, eta + 1);
+                delta = 1 - std::pow(value, power);
+            }
+            g[i] = details::clamp<Allele>(y + delta * width, lower, upper);
+        });
+    };
+}
 }
 }
 }
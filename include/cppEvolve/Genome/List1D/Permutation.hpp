@@ -0,0 +1,353 @@
+#ifndef LIST1D_PERMUTATION_H_
+#define LIST1D_PERMUTATION_H_
+
+#include "cppEvolve/utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace evolve {
+namespace list1d {
+
+/*!
+ * Operators for genomes which are permutations, such as the order in which
+ * to visit cities. Every child they produce is a permutation of its parents'
+ * alleles.
+ *
+ * Alleles must be non-negative integers (or chars), which index the tables
+ * used to find them in O(1); the tables are sized by the largest allele. The
+ * tables belong to the calling thread and are reused, so once they have
+ * grown the operators do not allocate.
+ */
+namespace permutation {
+namespace details {
+
+// Tables indexed by allele. A mark is set if it equals the current epoch,
+// so starting a new call clears every mark at once.
+struct Scratch {
+    struct Neighbors {
+        std::array<std::size_t, 4> alleles;
+        unsigned int count;
+    };
+
+    void begin(std::size_t bound) {
+        if (marks.size() < bound) {
+            marks.resize(bound, 0);
+            positions.resize(bound);
+            neighbors.resize(bound);
+            slots.resize(bound);
+        }
+        if (++epoch == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            epoch = 1;
+        }
+    }
+
+    bool marked(std::size_t allele) const { return marks[allele] == epoch; }
+
+    void mark(std::size_t allele) { marks[allele] = epoch; }
+
+    std::vector<std::uint32_t> marks;
+    std::vector<std::size_t> positions;
+    std::vector<Neighbors> neighbors;
+    std::vector<std::size_t> slots;
+    std::vector<std::size_t> remaining;
+    std::uint32_t epoch = 0;
+};
+
+inline Scratch& scratch() {
+    thread_local Scratch s;
+    return s;
+}
+
+template <typename Genome>
+std::size_t index(const Genome& g, std::size_t i) {
+    return static_cast<std::size_t>(g[i]);
+}
+
+// One more than the largest allele of 'g'
+template <typename Genome>
+std::size_t bound(const Genome& g) {
+    std::size_t largest = 0;
+    for (std::size_t i = 0; i < g.size(); ++i) {
+        largest = std::max(largest, index(g, i));
+    }
+    return largest + 1;
+}
+
+// Prepare 'g' to receive a child of 'like' and return the scratch tables
+template <typename Genome>
+Scratch& prepare(Genome& g, const Genome& like) {
+    utils::resizeLike(g, like);
+    auto& s = scratch();
+    s.begin(bound(like));
+    return s;
+}
+
+// Choose 0 <= first <= last <= size
+inline void randomSegment(std::size_t size, std::size_t& first,
+                          std::size_t& last) {
+    first = utils::random_uint(size + 1);
+    last = utils::random_uint(size + 1);
+    if (last < first)
+        std::swap(first, last);
+}
+
+inline void addNeighbor(Scratch::Neighbors& n, std::size_t allele) {
+    for (unsigned int k = 0; k < n.count; ++k) {
+        if (n.alleles[k] == allele)
+            return;
+    }
+    n.alleles[n.count++] = allele;
+}
+
+inline void removeNeighbor(Scratch::Neighbors& n, std::size_t allele) {
+    for (unsigned int k = 0; k < n.count; ++k) {
+        if (n.alleles[k] == allele) {
+            n.alleles[k] = n.alleles[--n.count];
+            return;
+        }
+    }
+}
+}
+}
+
+namespace crossover {
+
+/*!
+ * Order crossover (OX): a random segment is copied from g1 into the same
+ * positions of 'g', and the remaining positions are filled, starting after
+ * the segment, with the missing alleles in the order they follow the
+ * segment in g2.
+ */
+template <typename Genome>
+void orderedInto(const Genome& g1, const Genome& g2, Genome& g) {
+    namespace d = permutation::details;
+    auto& s = d::prepare(g, g1);
+    const auto size = g1.size();
+    if (size == 0)
+        return;
+    std::size_t first, last;
+    d::randomSegment(size, first, last);
+
+    for (auto i = first; i < last; ++i) {
+        g[i] = g1[i];
+        s.mark(d::index(g1, i));
+    }
+
+    // Exactly the positions outside the segment receive an allele
+    auto out = last % size;
+    for (std::size_t k = 0; k < size; ++k) {
+        const auto i = (last + k) % size;
+        if (!s.marked(d::index(g2, i))) {
+            g[out] = g2[i];
+            out = (out + 1) % size;
+        }
+    }
+}
+
+template <typename Genome>
+Genome ordered(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    orderedInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Partially mapped crossover (PMX): a random segment is copied from g1, and
+ * the other positions are taken from g2. An allele of g2 displaced by the
+ * segment is moved to the position found by following the mapping between
+ * the parents' segments until it leaves the segment.
+ */
+template <typename Genome>
+void partiallyMappedInto(const Genome& g1, const Genome& g2, Genome& g) {
+    namespace d = permutation::details;
+    auto& s = d::prepare(g, g1);
+    const auto size = g1.size();
+    std::size_t first, last;
+    d::randomSegment(size, first, last);
+
+    for (std::size_t i = 0; i < size; ++i) {
+        s.positions[d::index(g2, i)] = i;
+        g[i] = g2[i];
+    }
+    for (auto i = first; i < last; ++i) {
+        g[i] = g1[i];
+        s.mark(d::index(g1, i));
+    }
+
+    for (auto i = first; i < last; ++i) {
+        if (s.marked(d::index(g2, i)))
+            continue;
+        auto position = i;
+        while (position >= first && position < last) {
+            position = s.positions[d::index(g1, position)];
+        }
+        g[position] = g2[i];
+    }
+}
+
+template <typename Genome>
+Genome partiallyMapped(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    partiallyMappedInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Cycle crossover (CX): the positions are divided into the cycles of the
+ * mapping between the parents, and 'g' takes the alleles of alternate
+ * cycles from g1 and g2, so every allele keeps the position it has in one
+ * of the parents.
+ */
+template <typename Genome>
+void cycleInto(const Genome& g1, const Genome& g2, Genome& g) {
+    namespace d = permutation::details;
+    auto& s = d::prepare(g, g1);
+    const auto size = g1.size();
+    for (std::size_t i = 0; i < size; ++i) {
+        s.positions[d::index(g1, i)] = i;
+    }
+
+    // Marks record the positions assigned, indexed by the allele of g1
+    bool fromFirst = true;
+    for (std::size_t start = 0; start < size; ++start) {
+        if (s.marked(d::index(g1, start)))
+            continue;
+        auto i = start;
+        do {
+            s.mark(d::index(g1, i));
+            g[i] = fromFirst ? g1[i] : g2[i];
+            i = s.positions[d::index(g2, i)];
+        } while (i != start);
+        fromFirst = !fromFirst;
+    }
+}
+
+template <typename Genome>
+Genome cycle(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    cycleInto(g1, g2, g);
+    return g;
+}
+
+/*!
+ * Edge recombination crossover (ERX): builds a tour from the adjacencies of
+ * both parents (treated as cycles). Starting from the first allele of g1,
+ * each step moves to the unvisited neighbor with the fewest unvisited
+ * neighbors of its own, or to a random unvisited allele if there is none.
+ */
+template <typename Genome>
+void edgeRecombinationInto(const Genome& g1, const Genome& g2, Genome& g) {
+    namespace d = permutation::details;
+    auto& s = d::prepare(g, g1);
+    const auto size = g1.size();
+    if (size == 0)
+        return;
+
+    // Alleles not yet placed, with their slots in 'remaining', so that one
+    // can be removed or drawn at random in O(1)
+    s.remaining.clear();
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto allele = d::index(g1, i);
+        s.neighbors[allele].count = 0;
+        s.positions[allele] = i;
+        s.slots[allele] = s.remaining.size();
+        s.remaining.push_back(allele);
+    }
+    for (const Genome* parent : {&g1, &g2}) {
+        for (std::size_t i = 0; i < size; ++i) {
+            auto& n = s.neighbors[d::index(*parent, i)];
+            d::addNeighbor(n, d::index(*parent, (i + size - 1) % size));
+            d::addNeighbor(n, d::index(*parent, (i + 1) % size));
+        }
+    }
+
+    auto current = d::index(g1, 0);
+    for (std::size_t out = 0; out < size; ++out) {
+        g[out] = g1[s.positions[current]];
+        s.mark(current);
+
+        const auto slot = s.slots[current];
+        s.remaining[slot] = s.remaining.back();
+        s.slots[s.remaining[slot]] = slot;
+        s.remaining.pop_back();
+
+        const auto& n = s.neighbors[current];
+        for (unsigned int k = 0; k < n.count; ++k) {
+            d::removeNeighbor(s.neighbors[n.alleles[k]], current);
+        }
+
+        if (s.remaining.empty())
+            break;
+        auto next = s.remaining[utils::random_uint(s.remaining.size())];
+        unsigned int fewest = 5;
+        for (unsigned int k = 0; k < n.count; ++k) {
+            const auto candidate = n.alleles[k];
+            if (!s.marked(candidate) &&
+                s.neighbors[candidate].count < fewest) {
+                fewest = s.neighbors[candidate].count;
+                next = candidate;
+            }
+        }
+        current = next;
+    }
+}
+
+template <typename Genome>
+Genome edgeRecombination(const Genome& g1, const Genome& g2) {
+    Genome g{};
+    edgeRecombinationInto(g1, g2, g);
+    return g;
+}
+}
+
+namespace mutator {
+
+/*!
+ * Reverses a random segment of the Genome. For a tour this is a 2-opt move:
+ * only the two edges at the ends of the segment change.
+ */
+template <typename Genome>
+void inversion(Genome& g) {
+    std::size_t first, last;
+    permutation::details::randomSegment(g.size(), first, last);
+    std::reverse(g.begin() + first, g.begin() + last);
+}
+
+/*!
+ * As inversion, but reports the reversed positions [first, second] for use
+ * with a delta evaluator (see SimpleGA::setDeltaMutator)
+ */
+template <typename Genome>
+Change deltaInversion(Genome& g) {
+    std::size_t first, last;
+    permutation::details::randomSegment(g.size(), first, last);
+    if (last - first < 2)
+        return Change{Change::NONE, first, last};
+    std::reverse(g.begin() + first, g.begin() + last);
+    return Change{Change::REVERSE, first, last - 1};
+}
+
+/*!
+ * Removes the allele at a random position and inserts it at another random
+ * position, shifting the alleles in between.
+ */
+template <typename Genome>
+void insertion(Genome& g) {
+    const auto from = utils::random_uint(g.size());
+    const auto to = utils::random_uint(g.size());
+    if (from < to) {
+        std::rotate(g.begin() + from, g.begin() + from + 1,
+                    g.begin() + to + 1);
+    } else {
+        std::rotate(g.begin() + to, g.begin() + from, g.begin() + from + 1);
+    }
+}
+}
+}
+}
+
+#endif
@@ -11,51 +11,118 @@ namespace tree {
  */
 namespace crossover {
 
-/*!
- *  Selects a random node from one of the subtrees as the "source". Another node
- * is selected from the other tree of the same height as the first. A new Tree
- * is created which is a copy of the first but with the selected branch
- * replaced. The height of the new tree will be the same as the first tree.
- */
+namespace details {
+
+// Append the nodes of 'node' satisfying 'pred' to 'out', skipping subtrees
+// shallower than 'minDepth'
+template <typename T, typename Pred>
+void collect(BaseNode<T>* node, unsigned int minDepth, const Pred& pred,
+             std::vector<BaseNode<T>*>& out) {
+    if (node->getDepth() < minDepth)
+        return;
+    if (pred(node))
+        out.push_back(node);
+    for (auto child : node->getChildren()) {
+        collect(child, minDepth, pred, out);
+    }
+}
+
+template <typename T>
+std::vector<BaseNode<T>*>& candidates() {
+    thread_local std::vector<BaseNode<T>*> nodes;
+    nodes.clear();
+    return nodes;
+}
+
+inline std::vector<std::size_t>& flatCandidates() {
+    thread_local std::vector<std::size_t> nodes;
+    nodes.clear();
+    return nodes;
+}
+
 template <typename T>
-Tree<T>* singlePoint(const Tree<T>* left, const Tree<T>* right) {
-    auto tree = left->clone(); // Copy left
-
-    auto treeDepth = right->getDepth();
-    auto depth = utils::random_uint(treeDepth);
-
-    auto sourceNode = right->root; // Crossover from the right to the left
-    BaseNode<T>* prevSourceNode = nullptr;
-
-    for (unsigned int i = 0; i < depth; ++i) {
-        if (sourceNode->getChildren().empty()) {
-            sourceNode = prevSourceNode; // Do not copy terminators
-            break;
-        }
-        prevSourceNode = sourceNode;
-        sourceNode = sourceNode->getChildren()[utils::random_uint(
-            sourceNode->getChildren().size())];
+void singlePointInto(const Tree<T>* left, const Tree<T>* right,
+                     Tree<T>*& tree) {
+    // Copy left
+    if (tree) {
+        tree->assign(*left);
+    } else {
+        tree = left->clone();
     }
 
-    auto currentNode = tree->root;
-    BaseNode<T>* prevNode = nullptr;
-
-    for (unsigned int i = 0; i < depth; ++i) {
-        prevNode = currentNode;
-        auto nextNodeLocation =
-            utils::random_uint(currentNode->getChildren().size());
-        currentNode = currentNode->getChildren()[nextNodeLocation];
-
-        if (sourceNode->getDepth() == currentNode->getDepth()) {
-            auto& children = prevNode->getChildren();
-            delete currentNode;
-            children[nextNodeLocation] = sourceNode->clone();
-            break;
-        } else if (currentNode->getChildren().empty()) {
-            break; // This point should never be reached
-        }
+    // Crossover from the right to the left. Do not copy terminators.
+    auto& nodes = candidates<T>();
+    collect(right->root, 2, [](BaseNode<T>*) { return true; }, nodes);
+    if (nodes.empty())
+        return;
+    const auto sourceNode = nodes[utils::random_uint(nodes.size())];
+    const auto depth = sourceNode->getDepth();
+
+    nodes.clear();
+    const auto root = tree->root;
+    collect(root, depth, [root, depth](BaseNode<T>* node) {
+        return node != root && node->getDepth() == depth;
+    }, nodes);
+    if (nodes.empty())
+        return;
+    const auto currentNode = nodes[utils::random_uint(nodes.size())];
+
+    // Find the position before copyInto, which may delete 'currentNode'
+    auto parent = currentNode->getParent();
+    const auto index = parent->indexOf(currentNode);
+    parent->setChild(index, sourceNode->copyInto(currentNode));
+}
+
+template <typename T>
+void singlePointInto(const FlatTree<T>& left, const FlatTree<T>& right,
+                     FlatTree<T>& tree) {
+    tree = left; // Reuses the storage of 'tree'
+
+    auto& nodes = flatCandidates();
+    for (std::size_t i = 0; i < right.size(); ++i) {
+        if (right.getNumChildren(i) > 0)
+            nodes.push_back(i);
     }
+    if (nodes.empty())
+        return;
+    const auto sourceNode = nodes[utils::random_uint(nodes.size())];
+    const auto depth = right.getHeight(sourceNode);
+
+    nodes.clear();
+    for (std::size_t i = 1; i < tree.size(); ++i) {
+        if (tree.getHeight(i) == depth)
+            nodes.push_back(i);
+    }
+    if (nodes.empty())
+        return;
+    tree.replace(nodes[utils::random_uint(nodes.size())], right, sourceNode);
+}
+}
 
+/*!
+ * As singlePoint, but the child is written into 'tree'. For Tree<T>*, if
+ * 'tree' is not null its nodes are reused wherever possible instead of being
+ * reallocated. A FlatTree reuses its array.
+ */
+template <typename T, typename Genome = Tree<T>*>
+void singlePointInto(const Genome& left, const Genome& right, Genome& tree) {
+    details::singlePointInto(left, right, tree);
+}
+
+/*!
+ * Selects a random non-terminal node of the right tree as the "source".
+ * Another node, other than the root, is selected from the left tree with the
+ * same height as the first. Both are chosen uniformly among the candidates.
+ * A new Tree is created which is a copy of the left tree but with the
+ * selected branch replaced. The height of the new tree will be the same as
+ * the left tree.
+ * Works with both Tree<T>* and FlatTree<T> (e.g. singlePoint<int,
+ * FlatTree<int>>).
+ */
+template <typename T, typename Genome = Tree<T>*>
+Genome singlePoint(const Genome& left, const Genome& right) {
+    Genome tree{};
+    singlePointInto<T, Genome>(left, right, tree);
     return tree;
 }
 }
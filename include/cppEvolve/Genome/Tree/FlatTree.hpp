@@ -0,0 +1,221 @@
+#ifndef CPPEVOLVE_FLATTREE_H_
+#define CPPEVOLVE_FLATTREE_H_
+
+#include "cppEvolve/Genome/Tree/Operation.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace evolve {
+namespace tree {
+
+/*!
+ * A single node of a FlatTree: the ID of its operation, together with the
+ * height and number of nodes of the subtree it roots.
+ */
+struct FlatNode {
+    std::uint32_t op;
+    std::uint16_t arity;
+    std::uint16_t height;
+    std::uint32_t size;
+};
+
+/*!
+ * A tree genome stored as a single array of nodes in prefix order: each node
+ * is followed by the subtrees of its children, and the subtree rooted at
+ * index i occupies [i, i + getSize(i)). Copying a FlatTree copies one
+ * contiguous array, replacing a subtree is a splice of that array, and the
+ * size and depth of every subtree are stored rather than computed.
+ *
+ * Trees are created by TreeFactory::makeFlat and share ownership of the
+ * factory's operations, so they may outlive the factory.
+ */
+template <typename Rtype>
+class FlatTree {
+public:
+    FlatTree() = default;
+
+    FlatTree(std::shared_ptr<const OperationTable<Rtype>> _operations,
+             std::vector<FlatNode> _nodes)
+        : operations(std::move(_operations)), nodes(std::move(_nodes)) {}
+
+    /*!
+     * Evaluate the tree. The nodes are visited from last to first so that
+     * the arguments of each node are on top of a value stack when it is
+     * reached; its result is written over the first of them.
+     */
+    Rtype eval() const {
+        // The stack only grows. A terminator may itself evaluate a FlatTree,
+        // which then uses the stack above this tree's part of it, and may
+        // reallocate it; so it is addressed by index.
+        thread_local std::vector<Rtype> stack;
+        thread_local std::size_t used = 0;
+        const auto bottom = used;
+        used += nodes.size();
+        if (stack.size() < used)
+            stack.resize(used);
+
+        const auto table = operations->data();
+        auto top = bottom;
+        for (auto i = nodes.size(); i-- > 0;) {
+            const auto& operation = table[nodes[i].op];
+            top -= nodes[i].arity;
+            const auto value = operation.call(operation.instruction,
+                                              stack.data() + top);
+            stack[top++] = value;
+        }
+
+        used = bottom;
+        return stack[bottom];
+    }
+
+    /// Evaluate the tree with its inputs (see TreeFactory::addInput) read
+    /// from 'row'
+    Rtype eval(const Rtype* row) const {
+        auto& current = details::currentRow<Rtype>();
+        const auto previous = current;
+        current = row;
+        auto result = eval();
+        current = previous;
+        return result;
+    }
+
+    /// The height of the tree (a single terminator has depth 1)
+    unsigned int getDepth() const {
+        return nodes.empty() ? 0 : nodes[0].height;
+    }
+
+    /// The number of nodes in the tree
+    std::size_t size() const { return nodes.size(); }
+
+    bool empty() const { return nodes.empty(); }
+
+    /// The height of the subtree rooted at 'i'
+    unsigned int getHeight(std::size_t i) const { return nodes[i].height; }
+
+    /// The number of nodes in the subtree rooted at 'i'
+    std::size_t getSize(std::size_t i) const { return nodes[i].size; }
+
+    /// The number of children of node 'i'
+    unsigned int getNumChildren(std::size_t i) const { return nodes[i].arity; }
+
+    /// The index of child 'k' of node 'i'
+    std::size_t getChild(std::size_t i, unsigned int k) const {
+        assert(k < nodes[i].arity);
+        auto child = i + 1;
+        for (; k > 0; --k) {
+            child += nodes[child].size;
+        }
+        return child;
+    }
+
+    /// Get the name of the function at node 'i'
+    const std::string& getName(std::size_t i) const {
+        return (*operations)[nodes[i].op].name;
+    }
+
+    const std::vector<FlatNode>& getNodes() const { return nodes; }
+
+    /// A hash of the operations of the tree in prefix order, which (given
+    /// their arities) determine its structure
+    std::uint64_t hash() const {
+        std::uint64_t hash = nodes.size();
+        for (const auto& node : nodes) {
+            hash = utils::hashCombine(hash, node.op);
+        }
+        return hash;
+    }
+
+    /*!
+     * Replace the subtree rooted at 'pos' with the nodes in [first, last),
+     * which must form a complete subtree and must not belong to this tree.
+     */
+    void replace(std::size_t pos, const FlatNode* first, const FlatNode* last) {
+        const std::size_t oldSize = nodes[pos].size;
+        const std::size_t newSize = last - first;
+        const auto common = std::min(oldSize, newSize);
+
+        std::copy(first, first + common, nodes.begin() + pos);
+        if (newSize < oldSize) {
+            nodes.erase(nodes.begin() + pos + newSize,
+                        nodes.begin() + pos + oldSize);
+        } else {
+            nodes.insert(nodes.begin() + pos + oldSize, first + common, last);
+        }
+        updateAncestors(pos, static_cast<std::int64_t>(newSize) -
+                                 static_cast<std::int64_t>(oldSize));
+    }
+
+    /// Replace the subtree rooted at 'pos' with a copy of source's subtree
+    /// rooted at 'sourcePos'
+    void replace(std::size_t pos, const FlatTree& source,
+                 std::size_t sourcePos) {
+        assert(&source != this);
+        const auto first = source.nodes.data() + sourcePos;
+        replace(pos, first, first + source.nodes[sourcePos].size);
+    }
+
+    template <typename T>
+    friend std::ostream& operator<<(std::ostream& out, const FlatTree<T>& tree);
+
+private:
+    // Fix the sizes and heights of the nodes on the path to 'pos'
+    void updateAncestors(std::size_t pos, std::int64_t delta) {
+        thread_local std::vector<std::size_t> path;
+        path.clear();
+
+        std::size_t i = 0;
+        while (i != pos) {
+            path.push_back(i);
+            nodes[i].size += delta;
+            auto child = i + 1;
+            while (child + nodes[child].size <= pos) {
+                child += nodes[child].size;
+            }
+            i = child;
+        }
+
+        for (auto node = path.rbegin(); node != path.rend(); ++node) {
+            unsigned int height = 0;
+            auto child = *node + 1;
+            for (auto k = 0U; k < nodes[*node].arity; ++k) {
+                height = std::max<unsigned int>(height, nodes[child].height);
+                child += nodes[child].size;
+            }
+            nodes[*node].height = height + 1;
+        }
+    }
+
+    std::size_t print(std::ostream& out, std::size_t i) const {
+        out << getName(i);
+        auto next = i + 1;
+        if (nodes[i].arity > 0) {
+            out << "(";
+            for (auto k = 0U; k < nodes[i].arity; ++k) {
+                if (k > 0)
+                    out << ", ";
+                next = print(out, next);
+            }
+            out << ")";
+        }
+        return next;
+    }
+
+    std::shared_ptr<const OperationTable<Rtype>> operations;
+    std::vector<FlatNode> nodes;
+};
+
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const FlatTree<T>& tree) {
+    if (!tree.empty())
+        tree.print(out, 0);
+    return out;
+}
+}
+}
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef CPPEVOLVE_KERNELS_H_
+#define CPPEVOLVE_KERNELS_H_
+
+#include "cppEvolve/Genome/Tree/Operation.hpp"
+#include <cstddef>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace evolve {
+namespace tree {
+
+/*!
+ * Node functions with a block form for Program::evalColumns, registered with
+ * TreeFactory::addKernel. Each kernel provides the scalar function 'apply'
+ * and, when compiled with AVX2, overloads of 'apply' on packed floats and
+ * doubles. Blocks of other types use a plain loop the compiler may vectorize.
+ * Their default traits only declare the identities which also hold for
+ * floating point (x - x and x * 0 are not always 0).
+ */
+namespace kernels {
+
+template <typename Rtype>
+struct Add {
+    static const unsigned int arity = 2;
+    static Rtype apply(Rtype a, Rtype b) { return a + b; }
+    static NodeTraits<Rtype> traits() {
+        return NodeTraits<Rtype>().setIdentity(0).setCommutative();
+    }
+#ifdef __AVX2__
+    static __m256d apply(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    static __m256 apply(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+#endif
+};
+
+template <typename Rtype>
+struct Subtract {
+    static const unsigned int arity = 2;
+    static Rtype apply(Rtype a, Rtype b) { return a - b; }
+    static NodeTraits<Rtype> traits() {
+        return NodeTraits<Rtype>().setIdentity(0);
+    }
+#ifdef __AVX2__
+    static __m256d apply(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+    static __m256 apply(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+#endif
+};
+
+template <typename Rtype>
+struct Multiply {
+    static const unsigned int arity = 2;
+    static Rtype apply(Rtype a, Rtype b) { return a * b; }
+    static NodeTraits<Rtype> traits() {
+        return NodeTraits<Rtype>().setIdentity(1).setCommutative();
+    }
+#ifdef __AVX2__
+    static __m256d apply(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+    static __m256 apply(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+#endif
+};
+
+template <typename Rtype>
+struct Negate {
+    static const unsigned int arity = 1;
+    static Rtype apply(Rtype a) { return -a; }
+    static NodeTraits<Rtype> traits() { return NodeTraits<Rtype>(); }
+#ifdef __AVX2__
+    static __m256d apply(__m256d a) {
+        return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+    }
+    static __m256 apply(__m256 a) {
+        return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+    }
+#endif
+};
+}
+
+namespace details {
+
+// Apply 'Kernel' lane by lane, writing the result over the first argument
+template <typename Kernel, typename Rtype>
+void kernelLanes(Rtype* a, std::size_t width,
+                 std::integral_constant<unsigned int, 1>) {
+    for (std::size_t i = 0; i < width; ++i) {
+        a[i] = Kernel::apply(a[i]);
+    }
+}
+
+template <typename Kernel, typename Rtype>
+void kernelLanes(Rtype* a, std::size_t width,
+                 std::integral_constant<unsigned int, 2>) {
+    const auto b = a + blockSize;
+    for (std::size_t i = 0; i < width; ++i) {
+        a[i] = Kernel::apply(a[i], b[i]);
+    }
+}
+
+#ifdef __AVX2__
+// Blocks are padded to blockSize, so whole vectors may always be processed
+template <typename Kernel>
+void kernelLanes(double* a, std::size_t width,
+                 std::integral_constant<unsigned int, 1>) {
+    for (std::size_t i = 0; i < width; i += 4) {
+        _mm256_storeu_pd(a + i, Kernel::apply(_mm256_loadu_pd(a + i)));
+    }
+}
+
+template <typename Kernel>
+void kernelLanes(double* a, std::size_t width,
+                 std::integral_constant<unsigned int, 2>) {
+    const auto b = a + blockSize;
+    for (std::size_t i = 0; i < width; i += 4) {
+        _mm256_storeu_pd(a + i, Kernel::apply(_mm256_loadu_pd(a + i),
+                                              _mm256_loadu_pd(b + i)));
+    }
+}
+
+template <typename Kernel>
+void kernelLanes(float* a, std::size_t width,
+                 std::integral_constant<unsigned int, 1>) {
+    for (std::size_t i = 0; i < width; i += 8) {
+        _mm256_storeu_ps(a + i, Kernel::apply(_mm256_loadu_ps(a + i)));
+    }
+}
+
+template <typename Kernel>
+void kernelLanes(float* a, std::size_t width,
+                 std::integral_constant<unsigned int, 2>) {
+    const auto b = a + blockSize;
+    for (std::size_t i = 0; i < width; i += 8) {
+        _mm256_storeu_ps(a + i, Kernel::apply(_mm256_loadu_ps(a + i),
+                                              _mm256_loadu_ps(b + i)));
+    }
+}
+#endif
+
+template <typename Rtype, typename Kernel>
+Rtype* kernelBlock(const Instruction<Rtype>&, Rtype* top, const Rtype*,
+                   std::size_t, std::size_t width) {
+    top -= Kernel::arity * blockSize;
+    kernelLanes<Kernel>(
+        top, width, std::integral_constant<unsigned int, Kernel::arity>{});
+    return top + blockSize;
+}
+}
+}
+}
+
+#endif
@@ -11,38 +11,48 @@ namespace tree {
  */
 namespace mutator {
 
-/*!
- * Selects a random node from the tree. The node is then replaced with a
- * random sub tree such that the height of the tree is unaffected.
- */
+namespace details {
+
 template <typename T>
 void randomNode(Tree<T>* tree, const TreeFactory<T>& factory) {
-    auto treeDepth = tree->getDepth();
-    auto depth = utils::random_uint(treeDepth);
-
-    auto currentNode = tree->root;
-    BaseNode<T>* prevNode = nullptr;
-
-    for (unsigned int i = 0; i < depth; ++i) {
-        prevNode = currentNode;
-        auto nodeLocation =
-            utils::random_uint(currentNode->getChildren().size());
-        currentNode = currentNode->getChildren()[nodeLocation];
-
-        if (currentNode->getChildren().empty()) {
-            auto& children = prevNode->getChildren();
-            delete currentNode;
-            children[nodeLocation] = factory.createRandomTerminator();
-            return;
-        }
+    if (tree->getSize() == 1) {
+        delete tree->root;
+        tree->root = factory.createRandomTerminator();
+        return;
     }
 
-    auto childValue = utils::random_uint(currentNode->getChildren().size());
-    auto nodeDepth = currentNode->getChildren()[childValue]->getDepth();
-    delete currentNode->getChildren()[childValue];
+    auto index = 1 + utils::random_uint(tree->getSize() - 1);
+    auto node = tree->root->nodeAt(index);
+    auto parent = node->getParent();
+    auto nodeDepth = node->getDepth();
+
+    delete parent->setChild(parent->indexOf(node),
+                            factory.createRandomSubTree(nodeDepth - 1));
+}
+
+template <typename T>
+void randomNode(FlatTree<T>& tree, const TreeFactory<T>& factory) {
+    thread_local std::vector<FlatNode> subtree;
+    subtree.clear();
 
-    currentNode->getChildren()[childValue] =
-        factory.createRandomSubTree(nodeDepth - 1);
+    std::size_t node = 0;
+    if (tree.size() > 1) {
+        node = 1 + utils::random_uint(tree.size() - 1);
+    }
+    factory.createRandomFlatSubTree(subtree, tree.getHeight(node) - 1);
+    tree.replace(node, subtree.data(), subtree.data() + subtree.size());
+}
+}
+
+/*!
+ * Selects a node other than the root uniformly at random from the tree. The
+ * node is then replaced with a random sub tree of the same height, so the
+ * height of the tree is unaffected. Works with
+ * both Tree<T>* and FlatTree<T> (e.g. randomNode<int, FlatTree<int>>).
+ */
+template <typename T, typename Genome = Tree<T>*>
+void randomNode(Genome& tree, const TreeFactory<T>& factory) {
+    details::randomNode(tree, factory);
 }
 }
 }
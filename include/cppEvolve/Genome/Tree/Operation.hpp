@@ -0,0 +1,270 @@
+#ifndef CPPEVOLVE_OPERATION_H_
+#define CPPEVOLVE_OPERATION_H_
+
+#include "cppEvolve/utils.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace evolve {
+namespace tree {
+
+/// The number of rows evaluated together by Program::evalColumns
+constexpr std::size_t blockSize = 128;
+
+/*!
+ * A single instruction of a compiled Program. 'step' applies the instruction
+ * to a value stack whose top is just below 'top' and returns the new top.
+ * 'block' does the same for a stack of blocks of blockSize values, each
+ * holding one value per row, for 'width' rows whose inputs start at 'data'
+ * in a column major matrix with 'stride' rows. 'function' is the registered
+ * function with its type erased; only the steps know its real signature.
+ */
+template <typename Rtype>
+struct Instruction {
+    using Step = Rtype* (*)(const Instruction& instruction, Rtype* top,
+                            const Rtype* row);
+    using BlockStep = Rtype* (*)(const Instruction& instruction, Rtype* top,
+                                 const Rtype* data, std::size_t stride,
+                                 std::size_t width);
+
+    Step step;
+    BlockStep block;
+    void (*function)();
+    std::uint32_t column;
+    Rtype value;
+};
+
+/*!
+ * Properties of a registered function used by tree::simplify and by Program
+ * to share common subexpressions. The rules assume that node functions have
+ * no side effects. For example, for int:
+ *
+ *   sum:        NodeTraits<int>().setIdentity(0).setCommutative()
+ *   difference: NodeTraits<int>().setIdentity(0).setSelfResult(0)
+ *   product:    NodeTraits<int>().setIdentity(1).setAbsorbing(0)
+ *                   .setCommutative()
+ *   5:          NodeTraits<int>().setConstant()
+ */
+template <typename Rtype>
+struct NodeTraits {
+    /// A pure node's value depends only on its children. A pure terminator's
+    /// value does not change during one evaluation of the tree.
+    explicit NodeTraits(bool _pure = true) : pure(_pure) {}
+
+    /// A terminator whose value never changes (implies pure)
+    NodeTraits& setConstant() {
+        pure = constant = true;
+        return *this;
+    }
+
+    /// f(a, b) == f(b, a)
+    NodeTraits& setCommutative() {
+        commutative = true;
+        return *this;
+    }
+
+    /// f(x, e) == x (and f(e, x) == x if commutative)
+    NodeTraits& setIdentity(Rtype e) {
+        hasIdentity = true;
+        identity = e;
+        return *this;
+    }
+
+    /// f(x, z) == z (and f(z, x) == z if commutative)
+    NodeTraits& setAbsorbing(Rtype z) {
+        hasAbsorbing = true;
+        absorbing = z;
+        return *this;
+    }
+
+    /// f(x, x) == r
+    NodeTraits& setSelfResult(Rtype r) {
+        hasSelfResult = true;
+        selfResult = r;
+        return *this;
+    }
+
+    bool pure;
+    bool constant = false;
+    bool commutative = false;
+    bool hasIdentity = false, hasAbsorbing = false, hasSelfResult = false;
+    Rtype identity{}, absorbing{}, selfResult{};
+};
+
+/*!
+ * A function registered with a TreeFactory, in the forms used by FlatTree and
+ * Program. The operation's ID is its index in the OperationTable.
+ */
+template <typename Rtype>
+struct Operation {
+    using Call = Rtype (*)(const Instruction<Rtype>& instruction,
+                           const Rtype* args);
+
+    std::string name;
+    unsigned int arity;
+
+    /// Call the function of 'instruction'. 'args' holds the arguments from
+    /// last to first.
+    Call call;
+
+    /// The instruction compiled for nodes of this operation
+    Instruction<Rtype> instruction;
+
+    NodeTraits<Rtype> traits;
+};
+
+template <typename Rtype>
+using OperationTable = std::vector<Operation<Rtype>>;
+
+namespace details {
+
+// The input row read by terminals registered with TreeFactory::addInput
+template <typename Rtype>
+const Rtype*& currentRow() {
+    thread_local const Rtype* row = nullptr;
+    return row;
+}
+
+template <typename Rtype, typename... T, unsigned int... I>
+Rtype callReversed(Rtype (*f)(T...), const Rtype* args,
+                   const utils::Ints<I...>&) {
+    return f(args[sizeof...(T) - 1 - I]...);
+}
+
+// The Operation::call of each kind of operation
+template <typename Rtype, typename... T>
+Rtype applyCall(const Instruction<Rtype>& instruction, const Rtype* args) {
+    return callReversed(reinterpret_cast<Rtype (*)(T...)>(instruction.function),
+                        args, typename utils::Range<sizeof...(T) - 1>::type{});
+}
+
+template <typename Rtype>
+Rtype terminatorCall(const Instruction<Rtype>& instruction, const Rtype*) {
+    return reinterpret_cast<Rtype (*)()>(instruction.function)();
+}
+
+template <typename Rtype>
+Rtype inputCall(const Instruction<Rtype>& instruction, const Rtype*) {
+    return currentRow<Rtype>()[instruction.column];
+}
+
+template <typename Rtype, typename... T, unsigned int... I>
+Rtype callForward(Rtype (*f)(T...), const Rtype* args,
+                  const utils::Ints<I...>&) {
+    return f(args[I]...);
+}
+
+template <typename Rtype, typename... T>
+Rtype* applyStep(const Instruction<Rtype>& instruction, Rtype* top,
+                 const Rtype*) {
+    auto f = reinterpret_cast<Rtype (*)(T...)>(instruction.function);
+    top -= sizeof...(T);
+    *top = callForward(f, top,
+                       typename utils::Range<sizeof...(T) - 1>::type{});
+    return top + 1;
+}
+
+template <typename Rtype>
+Rtype* terminatorStep(const Instruction<Rtype>& instruction, Rtype* top,
+                      const Rtype*) {
+    *top = reinterpret_cast<Rtype (*)()>(instruction.function)();
+    return top + 1;
+}
+
+template <typename Rtype, typename... T, unsigned int... I>
+void applyLanes(Rtype (*f)(T...), Rtype* args, std::size_t width,
+                const utils::Ints<I...>&) {
+    for (std::size_t i = 0; i < width; ++i) {
+        args[i] = f(args[I * blockSize + i]...);
+    }
+}
+
+template <typename Rtype, typename... T>
+Rtype* applyBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                  const Rtype*, std::size_t, std::size_t width) {
+    auto f = reinterpret_cast<Rtype (*)(T...)>(instruction.function);
+    top -= sizeof...(T) * blockSize;
+    applyLanes(f, top, width,
+               typename utils::Range<sizeof...(T) - 1>::type{});
+    return top + blockSize;
+}
+
+template <typename Rtype>
+Rtype* terminatorBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                       const Rtype*, std::size_t, std::size_t width) {
+    auto f = reinterpret_cast<Rtype (*)()>(instruction.function);
+    for (std::size_t i = 0; i < width; ++i) {
+        top[i] = f();
+    }
+    return top + blockSize;
+}
+
+template <typename Rtype>
+Rtype* inputBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                  const Rtype* data, std::size_t stride, std::size_t width) {
+    std::copy(data + instruction.column * stride,
+              data + instruction.column * stride + width, top);
+    return top + blockSize;
+}
+
+template <typename Rtype>
+Rtype* constantStep(const Instruction<Rtype>& instruction, Rtype* top,
+                    const Rtype*) {
+    *top = instruction.value;
+    return top + 1;
+}
+
+template <typename Rtype>
+Rtype* constantBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                     const Rtype*, std::size_t, std::size_t width) {
+    std::fill(top, top + width, instruction.value);
+    return top + blockSize;
+}
+
+// Shared subexpressions are kept in registers below the value stack. The
+// distance from the top of the stack to the register is fixed at compile
+// time and stored in 'column'.
+template <typename Rtype>
+Rtype* storeStep(const Instruction<Rtype>& instruction, Rtype* top,
+                 const Rtype*) {
+    *(top - instruction.column) = top[-1];
+    return top;
+}
+
+template <typename Rtype>
+Rtype* storeBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                  const Rtype*, std::size_t, std::size_t width) {
+    std::copy(top - blockSize, top - blockSize + width,
+              top - instruction.column * blockSize);
+    return top;
+}
+
+template <typename Rtype>
+Rtype* loadStep(const Instruction<Rtype>& instruction, Rtype* top,
+                const Rtype*) {
+    *top = *(top - instruction.column);
+    return top + 1;
+}
+
+template <typename Rtype>
+Rtype* loadBlock(const Instruction<Rtype>& instruction, Rtype* top,
+                 const Rtype*, std::size_t, std::size_t width) {
+    auto source = top - instruction.column * blockSize;
+    std::copy(source, source + width, top);
+    return top + blockSize;
+}
+
+template <typename Rtype>
+Rtype* inputStep(const Instruction<Rtype>& instruction, Rtype* top,
+                 const Rtype* row) {
+    *top = row[instruction.column];
+    return top + 1;
+}
+}
+}
+}
+
+#endif
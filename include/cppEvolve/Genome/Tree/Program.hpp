@@ -0,0 +1,276 @@
+#ifndef CPPEVOLVE_PROGRAM_H_
+#define CPPEVOLVE_PROGRAM_H_
+
+#include "cppEvolve/Genome/Tree/Tree.hpp"
+#include "cppEvolve/Genome/Tree/FlatTree.hpp"
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+namespace evolve {
+namespace tree {
+
+/*!
+ * A tree compiled to a sequence of stack machine instructions in postfix
+ * order. Each instruction holds the registered function pointer and a
+ * trampoline which calls it on the top of the value stack, so evaluation is
+ * a single loop over an array with no virtual calls and no std::function.
+ *
+ * Compile once and evaluate many times: evalRows runs the program over every
+ * row of an input matrix, with the terminals registered by
+ * TreeFactory::addInput reading the columns of the current row. evalColumns
+ * instead takes a column major matrix and runs each instruction over blocks
+ * of blockSize rows at once, so the tree is traversed once per block rather
+ * than once per row.
+ *
+ * Pure subtrees (see NodeTraits) which occur more than once in a Tree are
+ * computed once, kept in a register below the value stack, and loaded again
+ * wherever they reoccur.
+ */
+template <typename Rtype>
+class Program {
+public:
+    Program() = default;
+
+    Program(const Tree<Rtype>& tree, const TreeFactory<Rtype>& factory) {
+        compile(tree, factory);
+    }
+
+    Program(const FlatTree<Rtype>& tree, const TreeFactory<Rtype>& factory) {
+        compile(tree, factory);
+    }
+
+    /// Compile 'tree', which must have been made by a factory registering
+    /// the same functions in the same order as 'factory'. The storage of the
+    /// previous program is reused.
+    void compile(const Tree<Rtype>& tree, const TreeFactory<Rtype>& factory) {
+        begin();
+        const auto& operations = factory.getOperations();
+        findShared(tree.root, operations);
+        emit(tree.root, 0, operations);
+        allocateRegisters();
+    }
+
+    void compile(const FlatTree<Rtype>& tree,
+                 const TreeFactory<Rtype>& factory) {
+        begin();
+        if (!tree.empty())
+            emit(tree, 0, factory.getOperations());
+    }
+
+    /// Run the program with its inputs read from 'row'
+    Rtype eval(const Rtype* row = nullptr) const {
+        auto& stack = scratch();
+        stack.resize(std::max(stack.size(), stackSize));
+        return run(stack.data(), row);
+    }
+
+    /*!
+     * Run the program on each of the 'rows' rows of the row major matrix
+     * 'data', which has 'columns' columns, writing the results to 'out'.
+     */
+    void evalRows(const Rtype* data, std::size_t rows, std::size_t columns,
+                  Rtype* out) const {
+        auto& stack = scratch();
+        stack.resize(std::max(stack.size(), stackSize));
+        for (std::size_t r = 0; r < rows; ++r) {
+            out[r] = run(stack.data(), data + r * columns);
+        }
+    }
+
+    /*!
+     * Run the program on each of the 'rows' rows of the column major matrix
+     * 'data' (column c starts at data + c * rows), writing the results to
+     * 'out'. Nodes registered with TreeFactory::addKernel process each block
+     * with vector instructions where available.
+     */
+    void evalColumns(const Rtype* data, std::size_t rows, Rtype* out) const {
+        assert(!code.empty());
+        auto& stack = scratch();
+        stack.resize(std::max(stack.size(), stackSize * blockSize));
+
+        for (std::size_t first = 0; first < rows; first += blockSize) {
+            const auto width = std::min(blockSize, rows - first);
+            const auto result = stack.data() + registers * blockSize;
+            auto top = result;
+            for (const auto& instruction : code) {
+                top = instruction.block(instruction, top, data + first, rows,
+                                        width);
+            }
+            std::copy(result, result + width, out + first);
+        }
+    }
+
+    std::vector<Rtype> evalColumns(const Rtype* data, std::size_t rows) const {
+        std::vector<Rtype> out(rows);
+        evalColumns(data, rows, out.data());
+        return out;
+    }
+
+    /// The number of instructions
+    std::size_t size() const { return code.size(); }
+
+    /// The largest number of values on the stack during evaluation,
+    /// including the registers holding shared subexpressions
+    std::size_t getStackSize() const { return stackSize; }
+
+    /// The number of shared subexpressions
+    std::size_t getNumShared() const { return registers; }
+
+private:
+    // A pure subexpression: its first occurrence, the number of times it
+    // occurs and the register holding its value once computed
+    struct Shared {
+        const BaseNode<Rtype>* first;
+        unsigned int count;
+        std::uint32_t reg;
+    };
+
+    static constexpr std::uint32_t noRegister = ~std::uint32_t(0);
+
+    void begin() {
+        code.clear();
+        buckets.clear();
+        classes.clear();
+        occurrences.clear();
+        fixups.clear();
+        height = 0;
+        stackSize = 0;
+        registers = 0;
+    }
+
+    void push(const Instruction<Rtype>& instruction, unsigned int arity) {
+        code.push_back(instruction);
+        height = height - arity + 1;
+        stackSize = std::max(stackSize, height);
+    }
+
+    void push(const Operation<Rtype>& operation) {
+        push(operation.instruction, operation.arity);
+    }
+
+    /*!
+     * Record for every node, in postfix order, the index in 'classes' of the
+     * subexpression it is an occurrence of (or noRegister), and return
+     * whether the subtree is pure.
+     */
+    bool findShared(const BaseNode<Rtype>* node,
+                    const OperationTable<Rtype>& operations) {
+        bool pure = (node->getID() == constantID) ||
+                    operations[node->getID()].traits.pure;
+        for (auto child : node->getChildren()) {
+            pure = findShared(child, operations) && pure;
+        }
+
+        auto index = noRegister;
+        if (pure && node->getSize() > 1) {
+            auto& candidates = buckets[structuralHash(node)];
+            for (auto candidate : candidates) {
+                if (sameTree(classes[candidate].first, node)) {
+                    index = candidate;
+                    ++classes[index].count;
+                    break;
+                }
+            }
+            if (index == noRegister) {
+                index = classes.size();
+                candidates.push_back(index);
+                classes.push_back(Shared{node, 1, noRegister});
+            }
+        }
+        occurrences.push_back(index);
+        return pure;
+    }
+
+    // 'first' is the postfix position of the first node of the subtree
+    void emit(const BaseNode<Rtype>* node, std::size_t first,
+              const OperationTable<Rtype>& operations) {
+        const auto index = occurrences[first + node->getSize() - 1];
+        Shared* common = nullptr;
+        if (index != noRegister && classes[index].count > 1) {
+            common = &classes[index];
+            if (common->reg != noRegister) {
+                fixups.push_back({code.size(), common->reg});
+                push(Instruction<Rtype>{details::loadStep<Rtype>,
+                                        details::loadBlock<Rtype>, nullptr,
+                                        static_cast<std::uint32_t>(height),
+                                        Rtype{}},
+                     0);
+                return;
+            }
+        }
+
+        for (auto child : node->getChildren()) {
+            emit(child, first, operations);
+            first += child->getSize();
+        }
+        if (node->getID() == constantID) {
+            push(Instruction<Rtype>{details::constantStep<Rtype>,
+                                    details::constantBlock<Rtype>, nullptr, 0,
+                                    node->eval()},
+                 0);
+        } else {
+            push(operations[node->getID()]);
+        }
+
+        if (common) {
+            common->reg = registers++;
+            fixups.push_back({code.size(), common->reg});
+            push(Instruction<Rtype>{details::storeStep<Rtype>,
+                                    details::storeBlock<Rtype>, nullptr,
+                                    static_cast<std::uint32_t>(height),
+                                    Rtype{}},
+                 1);
+        }
+    }
+
+    // Registers are placed below the value stack, so their distance from the
+    // top of the stack is only known once all of them have been counted
+    void allocateRegisters() {
+        for (const auto& fixup : fixups) {
+            code[fixup.first].column += registers - fixup.second;
+        }
+        stackSize += registers;
+    }
+
+    std::size_t emit(const FlatTree<Rtype>& tree, std::size_t i,
+                     const OperationTable<Rtype>& operations) {
+        auto next = i + 1;
+        for (auto k = 0U; k < tree.getNumChildren(i); ++k) {
+            next = emit(tree, next, operations);
+        }
+        push(operations[tree.getNodes()[i].op]);
+        return next;
+    }
+
+    Rtype run(Rtype* stack, const Rtype* row) const {
+        assert(!code.empty());
+        auto top = stack + registers;
+        for (const auto& instruction : code) {
+            top = instruction.step(instruction, top, row);
+        }
+        return stack[registers];
+    }
+
+    // Shared by every program evaluated on the calling thread
+    static std::vector<Rtype>& scratch() {
+        thread_local std::vector<Rtype> stack;
+        return stack;
+    }
+
+    std::vector<Instruction<Rtype>> code;
+    std::size_t height = 0;
+    std::size_t stackSize = 0;
+    std::size_t registers = 0;
+
+    // Compilation state, kept to reuse its storage
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> buckets;
+    std::vector<Shared> classes;
+    std::vector<std::uint32_t> occurrences;
+    std::vector<std::pair<std::size_t, std::uint32_t>> fixups;
+};
+}
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef CPPEVOLVE_SIMPLIFY_H_
+#define CPPEVOLVE_SIMPLIFY_H_
+
+#include "cppEvolve/Genome/Tree/Tree.hpp"
+
+namespace evolve {
+namespace tree {
+
+namespace details {
+
+template <typename Rtype>
+const NodeTraits<Rtype>& traitsOf(const BaseNode<Rtype>* node,
+                                  const OperationTable<Rtype>& operations) {
+    static const NodeTraits<Rtype> constant = NodeTraits<Rtype>().setConstant();
+    return (node->getID() == constantID) ? constant
+                                         : operations[node->getID()].traits;
+}
+
+template <typename Rtype>
+bool isConstant(const BaseNode<Rtype>* node,
+                const OperationTable<Rtype>& operations) {
+    return node->getNumChildren() == 0 && traitsOf(node, operations).constant;
+}
+
+// True if every node of the subtree is pure
+template <typename Rtype>
+bool isPure(const BaseNode<Rtype>* node,
+            const OperationTable<Rtype>& operations) {
+    if (!traitsOf(node, operations).pure)
+        return false;
+    for (auto child : node->getChildren()) {
+        if (!isPure(child, operations))
+            return false;
+    }
+    return true;
+}
+
+// Replace 'node' by 'replacement', deleting it. Returns 'replacement'.
+template <typename Rtype>
+BaseNode<Rtype>* substitute(BaseNode<Rtype>* node,
+                            BaseNode<Rtype>* replacement) {
+    delete node;
+    return replacement;
+}
+
+// Apply the identity, absorbing and self rules of a binary node
+template <typename Rtype>
+BaseNode<Rtype>* applyRules(BaseNode<Rtype>* node,
+                            const NodeTraits<Rtype>& traits,
+                            const OperationTable<Rtype>& operations) {
+    const auto& children = node->getChildren();
+    // Keep child i if the other one is constant. The constant must be the
+    // right operand unless f commutes.
+    for (unsigned int i = 0; i < 2; ++i) {
+        if (i == 1 && !traits.commutative)
+            continue;
+        if (!isConstant(children[1 - i], operations))
+            continue;
+
+        const auto value = children[1 - i]->eval();
+        if (traits.hasAbsorbing && value == traits.absorbing) {
+            return substitute(node, new Constant<Rtype>(value));
+        }
+        if (traits.hasIdentity && value == traits.identity) {
+            return substitute(node, node->takeChild(i));
+        }
+    }
+
+    if (traits.hasSelfResult && sameTree(children[0], children[1]) &&
+        isPure(children[0], operations)) {
+        return substitute(node, new Constant<Rtype>(traits.selfResult));
+    }
+    return node;
+}
+
+template <typename Rtype>
+BaseNode<Rtype>* simplify(BaseNode<Rtype>* node,
+                          const OperationTable<Rtype>& operations) {
+    for (unsigned int i = 0; i < node->getNumChildren(); ++i) {
+        auto child = node->getChildren()[i];
+        auto simplified = simplify(child, operations);
+        if (simplified != child) {
+            node->setChild(i, simplified);
+        }
+    }
+
+    const auto& traits = traitsOf(node, operations);
+    if (node->getNumChildren() == 0 || !traits.pure)
+        return node;
+
+    bool folded = true;
+    for (auto child : node->getChildren()) {
+        folded = folded && isConstant(child, operations);
+    }
+    if (folded) {
+        return substitute(node, new Constant<Rtype>(node->eval()));
+    }
+
+    if (node->getNumChildren() == 2) {
+        return applyRules(node, traits, operations);
+    }
+    return node;
+}
+}
+
+/*!
+ * Simplify 'tree', which must have been made by 'factory', using the traits
+ * its functions were registered with (see NodeTraits):
+ *
+ * - pure nodes whose children are all constants are replaced by a Constant
+ *   holding their value
+ * - f(x, e) becomes x for an identity e of f
+ * - f(x, z) becomes z for an absorbing z of f
+ * - f(x, x) becomes r for the self result r of f, if x is pure
+ *
+ * The rules are applied from the leaves up, so a whole constant subtree is
+ * folded in one pass. Returns the number of nodes removed.
+ */
+template <typename Rtype>
+unsigned int simplify(Tree<Rtype>& tree, const TreeFactory<Rtype>& factory) {
+    const auto before = tree.getSize();
+    tree.root = details::simplify(tree.root, factory.getOperations());
+    return before - tree.getSize();
+}
+}
+}
+
+#endif
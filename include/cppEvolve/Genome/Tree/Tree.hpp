@@ -2,7 +2,12 @@
 #define CPPEVOLVE_TREE_H_
 
 #include "cppEvolve/utils.hpp"
-#include <map>
+#include "cppEvolve/Pool.hpp"
+#include "cppEvolve/Genome/Tree/FlatTree.hpp"
+#include "cppEvolve/Genome/Tree/Kernels.hpp"
+#include <limits>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <algorithm>
 #include <iostream>
@@ -15,6 +20,10 @@ namespace evolve {
  */
 namespace tree {
 
+/// The ID of Constant nodes, which are made by tree::simplify rather than
+/// registered with a TreeFactory
+constexpr unsigned int constantID = std::numeric_limits<unsigned int>::max();
+
 /*!
  * The Node and Terminator classes wrap functions and are used to compose
  * function trees which are the genome of TreeGAs. The BaseNode class is used
@@ -23,6 +32,18 @@ namespace tree {
 template <typename Rtype>
 class BaseNode {
 public:
+    using Children =
+        std::vector<BaseNode<Rtype>*, utils::PoolAllocator<BaseNode<Rtype>*>>;
+
+    /// Nodes are allocated from the thread caching pool in cppEvolve/Pool.hpp
+    static void* operator new(std::size_t size) {
+        return utils::pool::allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size) {
+        utils::pool::deallocate(p, size);
+    }
+
     /// Destructor: Also destroys all child nodes
     virtual ~BaseNode() {
         for (auto child : this->children) {
@@ -34,22 +55,95 @@ public:
     virtual Rtype eval() const = 0;
 
     /// Get the node's children
-    std::vector<BaseNode<Rtype>*>& getChildren() { return children; }
-
-    /// Compute the depth of the tree from this node
-    unsigned int getDepth() const {
-        unsigned int max = 0;
-        for (auto child : children) {
-            auto depth = child->getDepth();
-            if (depth > max)
-                max = depth;
+    const Children& getChildren() const { return children; }
+
+    /// Get the node this node is a child of (null for the root)
+    BaseNode<Rtype>* getParent() const { return parent; }
+
+    /// The position of 'child' among the children of this node
+    unsigned int indexOf(const BaseNode<Rtype>* child) const {
+        return std::find(children.begin(), children.end(), child) -
+               children.begin();
+    }
+
+    /// The depth (height) of the tree from this node, a leaf having depth 1
+    unsigned int getDepth() const { return height; }
+
+    /// The number of nodes in the tree from this node
+    unsigned int getSize() const { return count; }
+
+    /// Append a child, updating the depth and size of this node's ancestors
+    void addChild(BaseNode<Rtype>* child) {
+        adopt(child);
+        refresh();
+    }
+
+    /*!
+     * Replace child 'i' with 'child', updating the depth and size of this
+     * node's ancestors. Returns the former child, which the caller owns.
+     */
+    BaseNode<Rtype>* setChild(unsigned int i, BaseNode<Rtype>* child) {
+        auto former = children[i];
+        children[i] = child;
+        child->parent = this;
+        refresh();
+        return former;
+    }
+
+    /*!
+     * Detach and return child 'i', which the caller owns. The position is
+     * left empty, so the node may only be deleted or given a new child with
+     * setChild afterwards.
+     */
+    BaseNode<Rtype>* takeChild(unsigned int i) {
+        auto child = children[i];
+        children[i] = nullptr;
+        child->parent = nullptr;
+        return child;
+    }
+
+    /*!
+     * The node at position 'index' of this subtree in prefix order, found in
+     * O(depth) using the cached sizes
+     */
+    BaseNode<Rtype>* nodeAt(unsigned int index) {
+        auto node = this;
+        while (index != 0) {
+            --index;
+            for (auto child : node->children) {
+                if (index < child->count) {
+                    node = child;
+                    break;
+                }
+                index -= child->count;
+            }
         }
-        return max + 1;
+        return node;
     }
 
     /// Create a deep copy of the node
     virtual BaseNode<Rtype>* clone() const = 0;
 
+    /*!
+     * Turn 'target' into a deep copy of this node, reusing the nodes of
+     * 'target' wherever they wrap the same function and allocating only where
+     * the trees differ. Returns the root of the copy; nodes of 'target' which
+     * could not be reused are deleted.
+     */
+    BaseNode<Rtype>* copyInto(BaseNode<Rtype>* target) const {
+        if (!target || target->ID != ID || ID == constantID) {
+            delete target;
+            return clone();
+        }
+        for (unsigned int i = 0; i < children.size(); ++i) {
+            target->children[i] = children[i]->copyInto(target->children[i]);
+            target->children[i]->parent = target;
+        }
+        target->height = height;
+        target->count = count;
+        return target;
+    }
+
     /// Get the number of child nodes
     virtual unsigned int getNumChildren() const = 0;
 
@@ -65,7 +159,28 @@ protected:
     BaseNode(const std::string& _name, unsigned int _id)
         : name(_name), ID(_id) {}
 
-    std::vector<BaseNode<Rtype>*> children;
+    void adopt(BaseNode<Rtype>* child) {
+        children.push_back(child);
+        child->parent = this;
+    }
+
+    // Recompute the depth and size of this node and its ancestors
+    void refresh() {
+        for (auto node = this; node; node = node->parent) {
+            unsigned int maxHeight = 0, total = 1;
+            for (auto child : node->children) {
+                maxHeight = std::max(maxHeight, child->height);
+                total += child->count;
+            }
+            node->height = maxHeight + 1;
+            node->count = total;
+        }
+    }
+
+    Children children;
+    BaseNode<Rtype>* parent = nullptr;
+    unsigned int height = 1;
+    unsigned int count = 1;
     const std::string name;
     const unsigned int ID;
 };
@@ -77,15 +192,19 @@ template <typename Genome>
 class Node : public BaseNode<typename Genome::result_type> {
 public:
     Node(Genome g, const std::string& _name, unsigned int _id)
-        : BaseNode<typename Genome::result_type>(_name, _id), val(g) {}
+        : BaseNode<typename Genome::result_type>(_name, _id), val(g) {
+        this->children.reserve(utils::count_args<Genome>::value);
+    }
 
     virtual ~Node() {}
 
     virtual BaseNode<typename Genome::result_type>* clone() const {
         auto node = new Node<Genome>(val, this->name, this->ID);
         for (auto child : this->children) {
-            node->children.push_back(child->clone());
+            node->adopt(child->clone());
         }
+        node->height = this->height;
+        node->count = this->count;
         return node;
     }
 
@@ -124,11 +243,7 @@ public:
 
     /// Create a copy of the node
     virtual BaseNode<typename Genome::result_type>* clone() const {
-        auto node = new Terminator<Genome>(val, this->name, this->ID);
-        for (auto child : this->children) {
-            node->children.push_back(child->clone());
-        }
-        return node;
+        return new Terminator<Genome>(val, this->name, this->ID);
     }
 
     /// Evaluate the node by calling the wrapped function
@@ -140,6 +255,122 @@ private:
     Genome val;
 };
 
+/*!
+ * A node calling a function pointer, as made by TreeFactory::addNode. The
+ * function is called directly rather than through std::function.
+ */
+template <typename Rtype, typename... T>
+class FunctionNode : public BaseNode<Rtype> {
+public:
+    using Function = Rtype (*)(T...);
+
+    FunctionNode(Function _function, const std::string& _name,
+                 unsigned int _id)
+        : BaseNode<Rtype>(_name, _id), function(_function) {
+        this->children.reserve(sizeof...(T));
+    }
+
+    virtual BaseNode<Rtype>* clone() const {
+        auto node = new FunctionNode(function, this->name, this->ID);
+        for (auto child : this->children) {
+            node->adopt(child->clone());
+        }
+        node->height = this->height;
+        node->count = this->count;
+        return node;
+    }
+
+    virtual Rtype eval() const override {
+        return call(typename utils::Range<sizeof...(T) - 1>::type{});
+    }
+
+    virtual unsigned int getNumChildren() const override {
+        return sizeof...(T);
+    }
+
+private:
+    template <unsigned int... I>
+    Rtype call(const utils::Ints<I...>&) const {
+        return function(this->children[I]->eval()...);
+    }
+
+    Function function;
+};
+
+/// A terminator calling a function pointer, as made by
+/// TreeFactory::addTerminator
+template <typename Rtype>
+class FunctionTerminator : public BaseNode<Rtype> {
+public:
+    using Function = Rtype (*)();
+
+    FunctionTerminator(Function _function, const std::string& _name,
+                       unsigned int _id)
+        : BaseNode<Rtype>(_name, _id), function(_function) {}
+
+    virtual BaseNode<Rtype>* clone() const {
+        return new FunctionTerminator(function, this->name, this->ID);
+    }
+
+    virtual Rtype eval() const override { return function(); }
+
+    virtual unsigned int getNumChildren() const override { return 0; }
+
+private:
+    Function function;
+};
+
+/// A terminator reading a column of the current input row, as made by
+/// TreeFactory::addInput
+template <typename Rtype>
+class Input : public BaseNode<Rtype> {
+public:
+    Input(unsigned int _column, const std::string& _name, unsigned int _id)
+        : BaseNode<Rtype>(_name, _id), column(_column) {}
+
+    virtual BaseNode<Rtype>* clone() const {
+        return new Input(column, this->name, this->ID);
+    }
+
+    virtual Rtype eval() const override {
+        return details::currentRow<Rtype>()[column];
+    }
+
+    virtual unsigned int getNumChildren() const override { return 0; }
+
+private:
+    unsigned int column;
+};
+
+/*!
+ * A node holding a fixed value, created by tree::simplify when folding
+ * constant subtrees. Its name is the value printed in full, for display only.
+ */
+template <typename Rtype>
+class Constant : public BaseNode<Rtype> {
+public:
+    explicit Constant(Rtype _value)
+        : BaseNode<Rtype>(format(_value), constantID), value(_value) {}
+
+    virtual BaseNode<Rtype>* clone() const { return new Constant(value); }
+
+    virtual Rtype eval() const override { return value; }
+
+    virtual unsigned int getNumChildren() const override { return 0; }
+
+    const Rtype& getValue() const { return value; }
+
+private:
+    static std::string format(const Rtype& value) {
+        std::ostringstream out;
+        out.precision(std::numeric_limits<Rtype>::max_digits10);
+        out << value;
+        return out.str();
+    }
+
+    Rtype value;
+};
+
 /*!
  * Tree class that is the genome for TreeGA
  */
@@ -148,18 +379,46 @@ class Tree {
 public:
     Tree(BaseNode<Rtype>* _root) : root(_root) {}
 
+    static void* operator new(std::size_t size) {
+        return utils::pool::allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size) {
+        utils::pool::deallocate(p, size);
+    }
+
     ~Tree() { delete root; }
 
     /// Create a deep copy of the tree
     Tree<Rtype>* clone() const { return new Tree<Rtype>(root->clone()); }
 
+    /// Make this tree a deep copy of 'other', reusing nodes where possible
+    void assign(const Tree<Rtype>& other) { root = other.root->copyInto(root); }
+
     /*!
      * Evaluates the root BaseNode
      */
     Rtype eval() const { return root->eval(); }
 
+    /// Evaluate the tree with its inputs (see TreeFactory::addInput) read
+    /// from 'row'
+    Rtype eval(const Rtype* row) const {
+        auto& current = details::currentRow<Rtype>();
+        const auto previous = current;
+        current = row;
+        auto result = root->eval();
+        current = previous;
+        return result;
+    }
+
     unsigned int getDepth() const { return root->getDepth(); }
 
+    /// The number of nodes in the tree
+    unsigned int getSize() const { return root->getSize(); }
+
+    /// A hash of the tree's structure (see structuralHash)
+    std::uint64_t hash() const;
+
     template <typename T>
     friend std::ostream& operator<<(std::ostream& out, const Tree<T>& tree);
 
@@ -186,59 +445,167 @@ std::ostream& operator<<(std::ostream& out, const BaseNode<T>& node) {
     return out;
 }
 
+/*!
+ * A hash of the functions composing the subtree at 'node', equal for any two
+ * subtrees for which sameTree holds. Constants are hashed by value.
+ */
+template <typename Rtype>
+std::uint64_t structuralHash(const BaseNode<Rtype>* node) {
+    std::uint64_t hash =
+        (node->getID() == constantID)
+            ? std::hash<Rtype>()(
+                  static_cast<const Constant<Rtype>*>(node)->getValue())
+            : node->getID();
+    for (auto child : node->getChildren()) {
+        hash = utils::hashCombine(hash, structuralHash(child));
+    }
+    return utils::hashCombine(hash, node->getNumChildren());
+}
+
+template <typename Rtype>
+std::uint64_t Tree<Rtype>::hash() const {
+    return structuralHash(root);
+}
+
+/// True if the subtrees at 'a' and 'b' are composed of the same functions
+template <typename Rtype>
+bool sameTree(const BaseNode<Rtype>* a, const BaseNode<Rtype>* b) {
+    if (a->getID() != b->getID() || a->getSize() != b->getSize())
+        return false;
+    if (a->getID() == constantID)
+        return a->eval() == b->eval();
+    for (unsigned int i = 0; i < a->getChildren().size(); ++i) {
+        if (!sameTree(a->getChildren()[i], b->getChildren()[i]))
+            return false;
+    }
+    return true;
+}
+
 /*
  * Factory used to generate random trees for the TreeGA.
+ *
+ * Each registered function has an ID, its index in a flat table which holds
+ * the function pointer and a plain function constructing its nodes. Random
+ * nodes and terminators are drawn from lists of IDs, uniformly or, once
+ * weights have been set with setWeight, from an alias table; either way in
+ * O(1).
  */
 template <typename Rtype>
 class TreeFactory {
 public:
-    TreeFactory(unsigned int _depth = 5) : depth(_depth), currentID(0) {}
+    TreeFactory(unsigned int _depth = 5)
+        : depth(_depth),
+          operations(std::make_shared<OperationTable<Rtype>>()) {}
 
-    /// Register a node function (i.e., a function taking 1 or more arguments)
+    /*!
+     * Register a node function (i.e., a function taking 1 or more arguments).
+     * 'traits' declares the properties used by tree::simplify.
+     */
     template <typename... T>
-    void addNode(Rtype (*f)(T...), const std::string& name) {
-        static_assert(sizeof...(T) > 0,
-                      "Node function with 0 arguments should be terminator");
-        const auto val = currentID;
+    void addNode(Rtype (*f)(T...), const std::string& name,
+                 NodeTraits<Rtype> traits = NodeTraits<Rtype>(false)) {
+        registerNode(f, name, details::applyBlock<Rtype, T...>, traits);
+    }
 
-        // explicitly capture to avoid bug in gcc
-        std::function<BaseNode<Rtype>*()> func = [f, name, val]() {
-            return new Node<std::function<Rtype(T...)>>(f, name, val);
-        };
-        nodes[currentID++] = func;
+    /*!
+     * Register a node whose Program::evalColumns form processes whole blocks
+     * of rows at once (see cppEvolve/Genome/Tree/Kernels.hpp), e.g.
+     * factory.addKernel<tree::kernels::Add>("sum")
+     */
+    template <template <typename> class Kernel>
+    void addKernel(const std::string& name,
+                   NodeTraits<Rtype> traits = Kernel<Rtype>::traits()) {
+        registerNode(&Kernel<Rtype>::apply, name,
+                     details::kernelBlock<Rtype, Kernel<Rtype>>, traits);
+    }
+
+    /*!
+     * Register a terminator (i.e., a function taking no arguments). Mark
+     * terminators returning a fixed value with NodeTraits::setConstant so
+     * that tree::simplify can fold them.
+     */
+    void addTerminator(Rtype (*f)(), const std::string& name,
+                       NodeTraits<Rtype> traits = NodeTraits<Rtype>(false)) {
+        terminatorIDs.push_back(addEntry(Entry{
+            createTerminator, reinterpret_cast<void (*)()>(f), 0, 1}));
+
+        addOperation(name, 0, details::terminatorCall<Rtype>,
+                     Instruction<Rtype>{details::terminatorStep<Rtype>,
+                                        details::terminatorBlock<Rtype>,
+                                        reinterpret_cast<void (*)()>(f), 0,
+                                        Rtype{}},
+                     traits);
     }
 
-    /// Register a terminator (i.e., a function taking no arguments)
-    void addTerminator(Rtype (*f)(), const std::string& name) {
-        const auto val = currentID;
-        std::function<BaseNode<Rtype>*()> func = [f, name, val]() {
-            return new Terminator<std::function<Rtype()>>(f, name, val);
-        };
-        terminators[currentID++] = func;
+    /*!
+     * Register a terminator which reads column 'column' of the input row
+     * passed to eval(row) or Program::evalRows
+     */
+    void addInput(const std::string& name, unsigned int column) {
+        terminatorIDs.push_back(
+            addEntry(Entry{createInput, nullptr, column, 1}));
+
+        addOperation(name, 0, details::inputCall<Rtype>,
+                     Instruction<Rtype>{details::inputStep<Rtype>,
+                                        details::inputBlock<Rtype>, nullptr,
+                                        column, Rtype{}},
+                     NodeTraits<Rtype>());
+    }
+
+    /*!
+     * Make the function registered as 'name' 'weight' times as likely to be
+     * chosen as a function of weight 1 (the default) when a random node or
+     * terminator is created. Returns false if there is no such function.
+     */
+    bool setWeight(const std::string& name, double weight) {
+        assert(weight >= 0);
+        for (unsigned int id = 0; id < entries.size(); ++id) {
+            if ((*operations)[id].name == name) {
+                entries[id].weight = weight;
+                buildTable(nodeIDs, nodeTable);
+                buildTable(terminatorIDs, terminatorTable);
+                weighted = true;
+                return true;
+            }
+        }
+        return false;
     }
 
     /// Create a tree with the registered functions
     Tree<Rtype>* make() const {
-        assert(!terminators.empty() && !nodes.empty());
+        assert(!terminatorIDs.empty() && !nodeIDs.empty());
         auto tree = new Tree<Rtype>(createRandomSubTree(depth));
 
         return tree;
     }
 
+    /// Create a FlatTree with the registered functions
+    FlatTree<Rtype> makeFlat() const {
+        assert(!terminatorIDs.empty() && !nodeIDs.empty());
+        std::vector<FlatNode> flat;
+        createRandomFlatSubTree(flat, depth);
+        return FlatTree<Rtype>(operations, std::move(flat));
+    }
+
+    /*!
+     * A FlatTree of the same nodes as 'tree', which must have been made by
+     * this factory and hold no Constant nodes (see tree::simplify)
+     */
+    FlatTree<Rtype> flatten(const Tree<Rtype>& tree) const {
+        std::vector<FlatNode> flat;
+        flat.reserve(tree.getSize());
+        flattenSubTree(flat, tree.root);
+        return FlatTree<Rtype>(operations, std::move(flat));
+    }
+
     /// Create a random node
     /// Node: This node must not be eval'd until it has valid children,
     ///      to get a valid node, call createRandomSubTree
-    BaseNode<Rtype>* createRandomNode() const {
-        auto loc = nodes.begin();
-        std::advance(loc, utils::random_uint(nodes.size()));
-        return ((*loc).second)();
-    }
+    BaseNode<Rtype>* createRandomNode() const { return create(randomNodeID()); }
 
     /// Create a random terminator
     BaseNode<Rtype>* createRandomTerminator() const {
-        auto loc = terminators.begin();
-        std::advance(loc, utils::random_uint(terminators.size()));
-        return loc->second();
+        return create(randomTerminatorID());
     }
 
     /// Create a random subtree
@@ -251,17 +618,151 @@ public:
         } else {
             root = createRandomNode();
             for (unsigned int i = 0; i < root->getNumChildren(); ++i) {
-                root->getChildren().push_back(createRandomSubTree(depth - 1));
+                root->addChild(createRandomSubTree(depth - 1));
             }
         }
         return root;
     }
 
+    /*!
+     * Append a random subtree of the given depth to 'out' in the prefix
+     * encoding used by FlatTree
+     */
+    void createRandomFlatSubTree(std::vector<FlatNode>& out,
+                                 unsigned int depth = 5) const {
+        const auto index = out.size();
+        const auto id = (depth == 0) ? randomTerminatorID() : randomNodeID();
+        const auto arity = (*operations)[id].arity;
+        out.push_back(FlatNode{id, static_cast<std::uint16_t>(arity), 1, 1});
+
+        unsigned int height = 0;
+        for (unsigned int i = 0; i < arity; ++i) {
+            const auto child = out.size();
+            createRandomFlatSubTree(out, depth - 1);
+            height = std::max<unsigned int>(height, out[child].height);
+        }
+        out[index].height = height + 1;
+        out[index].size = out.size() - index;
+    }
+
+    /// Append the subtree at 'node' to 'out' in the prefix encoding used by
+    /// FlatTree
+    void flattenSubTree(std::vector<FlatNode>& out,
+                        const BaseNode<Rtype>* node) const {
+        assert(node->getID() < operations->size());
+        const auto arity = node->getNumChildren();
+        out.push_back(FlatNode{node->getID(),
+                               static_cast<std::uint16_t>(arity),
+                               static_cast<std::uint16_t>(node->getDepth()),
+                               node->getSize()});
+        for (auto child : node->getChildren()) {
+            flattenSubTree(out, child);
+        }
+    }
+
+    /// The registered functions, indexed by ID
+    const OperationTable<Rtype>& getOperations() const { return *operations; }
+
 protected:
+    // A registered function. 'create' makes a node for it with the given ID.
+    struct Entry {
+        BaseNode<Rtype>* (*create)(const Entry& entry, const std::string& name,
+                                   unsigned int id);
+        void (*function)();
+        unsigned int column;
+        double weight;
+    };
+
+    template <typename... T>
+    static BaseNode<Rtype>* createNode(const Entry& entry,
+                                       const std::string& name,
+                                       unsigned int id) {
+        return new FunctionNode<Rtype, T...>(
+            reinterpret_cast<Rtype (*)(T...)>(entry.function), name, id);
+    }
+
+    static BaseNode<Rtype>* createTerminator(const Entry& entry,
+                                             const std::string& name,
+                                             unsigned int id) {
+        return new FunctionTerminator<Rtype>(
+            reinterpret_cast<Rtype (*)()>(entry.function), name, id);
+    }
+
+    static BaseNode<Rtype>* createInput(const Entry& entry,
+                                        const std::string& name,
+                                        unsigned int id) {
+        return new Input<Rtype>(entry.column, name, id);
+    }
+
+    BaseNode<Rtype>* create(unsigned int id) const {
+        const auto& entry = entries[id];
+        return entry.create(entry, (*operations)[id].name, id);
+    }
+
+    template <typename... T>
+    void registerNode(Rtype (*f)(T...), const std::string& name,
+                      typename Instruction<Rtype>::BlockStep block,
+                      const NodeTraits<Rtype>& traits) {
+        static_assert(sizeof...(T) > 0,
+                      "Node function with 0 arguments should be terminator");
+        nodeIDs.push_back(addEntry(Entry{
+            createNode<T...>, reinterpret_cast<void (*)()>(f), 0, 1}));
+
+        addOperation(name, sizeof...(T), details::applyCall<Rtype, T...>,
+                     Instruction<Rtype>{details::applyStep<Rtype, T...>, block,
+                                        reinterpret_cast<void (*)()>(f), 0,
+                                        Rtype{}},
+                     traits);
+    }
+
+    unsigned int addEntry(const Entry& entry) {
+        entries.push_back(entry);
+        return entries.size() - 1;
+    }
+
+    void buildTable(const std::vector<unsigned int>& ids,
+                    utils::AliasTable& table) {
+        std::vector<double> weights;
+        for (auto id : ids) {
+            weights.push_back(entries[id].weight);
+        }
+        table.build(weights.begin(), weights.end());
+    }
+
+    unsigned int randomNodeID() const {
+        return nodeIDs[weighted ? nodeTable()
+                                : utils::random_uint(nodeIDs.size())];
+    }
+
+    unsigned int randomTerminatorID() const {
+        return terminatorIDs[weighted
+                                 ? terminatorTable()
+                                 : utils::random_uint(terminatorIDs.size())];
+    }
+
+    void addOperation(const std::string& name, unsigned int arity,
+                      typename Operation<Rtype>::Call call,
+                      Instruction<Rtype> instruction,
+                      const NodeTraits<Rtype>& traits) {
+        // Flat trees already made, and copies of this factory, keep the old
+        // table
+        if (operations.use_count() > 1) {
+            operations = std::make_shared<OperationTable<Rtype>>(*operations);
+        }
+        operations->push_back(Operation<Rtype>{name, arity, call,
+                                               instruction, traits});
+        if (weighted) {
+            buildTable(nodeIDs, nodeTable);
+            buildTable(terminatorIDs, terminatorTable);
+        }
+    }
+
     unsigned int depth;
-    unsigned int currentID;
-    std::map<unsigned int, std::function<BaseNode<Rtype>*()>> nodes;
-    std::map<unsigned int, std::function<BaseNode<Rtype>*()>> terminators;
+    std::vector<Entry> entries; // indexed by ID, as are the operations
+    std::vector<unsigned int> nodeIDs, terminatorIDs;
+    utils::AliasTable nodeTable, terminatorTable;
+    bool weighted = false;
+    std::shared_ptr<OperationTable<Rtype>> operations;
 };
 }
 }
@@ -0,0 +1,192 @@
+#ifndef ISLANDMODEL_H_
+#define ISLANDMODEL_H_
+
+#include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace evolve {
+
+/*!
+ * Determines which islands receive the emigrants of each island.
+ */
+enum class Topology {
+    /// Island i sends to island i + 1 (wrapping around)
+    RING,
+
+    /// Every island sends to every other island
+    FULLY_CONNECTED,
+
+    /// Each migration, an island sends to one other island chosen at random
+    RANDOM
+};
+
+/*!
+ * Runs several independent GAs (the islands) on separate threads, copying the
+ * fittest members of each island to its neighbours at a regular interval.
+ * The GA type may be SimpleGA or TreeGA, or any type with the same
+ * initialize/step/emigrants/immigrate interface.
+ *
+ * Each island thread seeds its own engine from the model's seed and its island
+ * number. Migrants are posted to per-island mailboxes which are only locked
+ * to append or drain, so islands never wait for each other. As a consequence
+ * the generation at which migrants arrive depends on thread timing.
+ */
+template <typename GA>
+class IslandModel {
+public:
+    using Genome = typename GA::GenomeType;
+    using Factory = std::function<std::unique_ptr<GA>(unsigned int)>;
+
+    /*!
+     * @param islands The number of islands (and threads)
+     *
+     * @param factory A function constructing the GA for the given island
+     * number
+     */
+    IslandModel(unsigned int islands, Factory factory) : mailboxes(islands) {
+        assert(islands > 0);
+        for (auto i = 0U; i < islands; ++i) {
+            gas.push_back(factory(i));
+        }
+    }
+
+    ~IslandModel() {
+        for (auto& mailbox : mailboxes) {
+            for (auto& migrant : mailbox.migrants) {
+                utils::release(migrant.genome);
+            }
+        }
+    }
+
+    /*!
+     * Every 'interval' generations, each island sends copies of its 'count'
+     * fittest members to the islands chosen by 'topology'. Migrants replace
+     * the least fit members of the receiving island.
+     */
+    void setMigration(unsigned int _interval, std::size_t _count,
+                      Topology _topology = Topology::RING) {
+        interval = _interval;
+        count = _count;
+        topology = _topology;
+    }
+
+    /// Set the seed from which the engine of each island thread is derived
+    void setSeed(std::uint64_t _seed) { seed = _seed; }
+
+    /*!
+     * Evolve every island for 'generations' generations, then print the best
+     * individual found on any island.
+     */
+    void run(unsigned int generations) {
+        std::vector<std::thread> threads;
+        for (auto i = 0U; i < gas.size(); ++i) {
+            threads.emplace_back([this, i, generations]() {
+                evolve(i, generations);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        getBestIsland().printBest(std::cout);
+    }
+
+    /// The island whose historically best member is the fittest
+    const GA& getBestIsland() const {
+        auto best = gas.begin();
+        for (auto iter = gas.begin(); iter != gas.end(); ++iter) {
+            if (utils::better((*iter)->getOrdering(), (*iter)->getBestScore(),
+                              (*best)->getBestScore()))
+                best = iter;
+        }
+        return **best;
+    }
+
+    /// The fitness of the best member found on any island
+    double getBestScore() const { return getBestIsland().getBestScore(); }
+
+    GA& getIsland(unsigned int i) { return *gas[i]; }
+    const GA& getIsland(unsigned int i) const { return *gas[i]; }
+
+    unsigned int getNumIslands() const { return gas.size(); }
+
+protected:
+    struct Mailbox {
+        std::mutex mutex;
+        std::vector<Individual<Genome>> migrants;
+    };
+
+    void evolve(unsigned int island, unsigned int generations) {
+        utils::seed(seed + island);
+
+        auto& ga = *gas[island];
+        ga.initialize();
+
+        std::vector<Individual<Genome>> arrivals;
+        for (auto generation = 1U; generation <= generations; ++generation) {
+            ga.step();
+
+            if (interval != 0 && count != 0 && gas.size() > 1 &&
+                generation % interval == 0) {
+                emigrate(island);
+
+                auto& mailbox = mailboxes[island];
+                {
+                    std::lock_guard<std::mutex> lock(mailbox.mutex);
+                    arrivals.swap(mailbox.migrants);
+                }
+                if (!arrivals.empty()) {
+                    ga.immigrate(arrivals);
+                }
+            }
+        }
+    }
+
+    void emigrate(unsigned int island) {
+        const auto islands = gas.size();
+        auto& ga = *gas[island];
+
+        switch (topology) {
+        case Topology::RING:
+            post((island + 1) % islands, ga.emigrants(count));
+            break;
+        case Topology::FULLY_CONNECTED:
+            for (auto target = 0U; target < islands; ++target) {
+                if (target != island)
+                    post(target, ga.emigrants(count));
+            }
+            break;
+        case Topology::RANDOM: {
+            auto target = utils::random_uint(islands - 1);
+            post(target >= island ? target + 1 : target, ga.emigrants(count));
+            break;
+        }
+        }
+    }
+
+    void post(unsigned int target,
+              std::vector<Individual<Genome>>&& migrants) {
+        auto& mailbox = mailboxes[target];
+        std::lock_guard<std::mutex> lock(mailbox.mutex);
+        for (auto& migrant : migrants) {
+            mailbox.migrants.push_back(std::move(migrant));
+        }
+    }
+
+    std::vector<std::unique_ptr<GA>> gas;
+    std::vector<Mailbox> mailboxes;
+
+    unsigned int interval = 10;
+    std::size_t count = 1;
+    Topology topology = Topology::RING;
+    std::uint64_t seed = 0;
+};
+}
+
+#endif
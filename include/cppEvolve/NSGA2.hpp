@@ -0,0 +1,327 @@
+#ifndef NSGA2_H_
+#define NSGA2_H_
+
+#include "cppEvolve/utils.hpp"
+#include "cppEvolve/Pareto.hpp"
+#include "cppEvolve/SimpleGA.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+namespace evolve {
+
+/// Function which returns the M objective values of a member of the
+/// population
+template <typename Genome, std::size_t M>
+using MultiEvaluatorType = std::function<std::array<double, M>(const Genome&)>;
+
+/*!
+ * A multi-objective genetic algorithm (NSGA-II). Each generation PopSize
+ * children are bred from parents chosen by binary tournament, and the
+ * fittest PopSize of the parents and children survive. Fitness is the rank
+ * of an individual's non-dominated front (see pareto::sortFronts), with ties
+ * broken in favor of the less crowded (see pareto::crowding).
+ *
+ * By default every objective is minimized; see setOrdering. The
+ * non-dominated solutions found over the whole run are kept in an archive,
+ * available from getFront. Genomes must be held by value.
+ *
+ * @param M The number of objectives
+ * @param PopSize The size of the population
+ */
+template <typename Genome, std::size_t M, std::size_t PopSize = 100>
+class NSGA2 {
+public:
+    using Objectives = std::array<double, M>;
+
+    /// A member of the archive
+    struct Solution {
+        Genome genome;
+        Objectives objectives;
+    };
+
+    /*!
+     * @param _generator A function which will return instances of Genome to be
+     * used in the initial population
+     *
+     * @param _evaluator A function which returns the objectives of a member of
+     * the population
+     *
+     * @param _crossover A function which returns a new member of the population
+     * by combining two parents
+     *
+     * @param _mutator A function which will alter a member of the population in
+     * some way
+     */
+    NSGA2(GeneratorType<Genome> _generator,
+          MultiEvaluatorType<Genome, M> _evaluator,
+          CrossoverType<Genome> _crossover, MutatorType<Genome> _mutator)
+        : generator(_generator),
+          evaluator(_evaluator),
+          crossover([_crossover](const Genome& g1, const Genome& g2,
+                                 Genome& child) { child = _crossover(g1, g2); }),
+          mutator(_mutator) {
+        orderings.fill(Ordering::LOWER);
+    }
+
+    /// As above, but '_crossover' writes the child over a genome retained
+    /// from a discarded member
+    NSGA2(GeneratorType<Genome> _generator,
+          MultiEvaluatorType<Genome, M> _evaluator,
+          CrossoverIntoType<Genome> _crossover, MutatorType<Genome> _mutator)
+        : generator(_generator),
+          evaluator(_evaluator),
+          crossover(_crossover),
+          mutator(_mutator) {
+        orderings.fill(Ordering::LOWER);
+    }
+
+    using GenomeType = Genome;
+
+    void run(unsigned int generations, unsigned int logFrequency = 100) {
+        initialize();
+
+        for (auto i = 0U; i < generations; ++i) {
+            step();
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Generation(" << i
+                          << ") - Front size:" << archive.size() << std::endl;
+            }
+        }
+        printFront(std::cout);
+    }
+
+    /// Fill the population with members from the generator
+    void initialize() {
+        members.clear();
+        archive.clear();
+        members.reserve(2 * PopSize);
+        while (members.size() < PopSize) {
+            members.push_back(Member{generator(), Objectives{}, false, 0, 0});
+        }
+        evaluate();
+        select();
+    }
+
+    /// Breed PopSize children, then keep the fittest PopSize members
+    void step() {
+        members.resize(2 * PopSize);
+        for (auto i = PopSize; i < 2 * PopSize; ++i) {
+            auto& child = members[i];
+            crossover(members[tournament()].genome,
+                      members[tournament()].genome, child.genome);
+            if (utils::random_real() < mutationRate) {
+                mutator(child.genome);
+            }
+            child.evaluated = false;
+        }
+        evaluate();
+        select();
+    }
+
+    /*!
+     * The non-dominated solutions found so far, at most getArchiveSize() of
+     * them. When there are more, the most crowded are dropped, measured by
+     * their crowding distance among all of the non-dominated solutions.
+     */
+    const std::vector<Solution>& getFront() const { return archive; }
+
+    /// Print the objectives of each solution in the archive
+    void printFront(std::ostream& out) const {
+        out << "Front:" << std::endl;
+        for (const auto& solution : archive) {
+            for (auto value : solution.objectives) {
+                out << value << " ";
+            }
+            out << std::endl;
+        }
+    }
+
+    /// Set whether HIGHER or LOWER values of 'objective' are better
+    void setOrdering(std::size_t objective, Ordering ordering) {
+        assert(objective < M);
+        orderings[objective] = ordering;
+    }
+
+    Ordering getOrdering(std::size_t objective) const {
+        return orderings[objective];
+    }
+
+    /// Set the probability that a child is mutated
+    void setMutationRate(float rate) { mutationRate = rate; }
+
+    /// Set the number of solutions kept in the archive (PopSize by default)
+    void setArchiveSize(std::size_t size) { archiveSize = size; }
+
+    std::size_t getArchiveSize() const { return archiveSize; }
+
+    /// The current population with their objectives, in no particular order
+    std::vector<Solution> getPopulation() const {
+        std::vector<Solution> result;
+        for (const auto& member : members) {
+            result.push_back(Solution{member.genome, member.objectives});
+        }
+        return result;
+    }
+
+protected:
+    struct Member {
+        Genome genome;
+        Objectives objectives;
+        bool evaluated;
+        unsigned int rank;
+        double crowding;
+    };
+
+    // The objectives with those to be maximized negated
+    pareto::Point<M> minimized(const Objectives& objectives) const {
+        auto point = objectives;
+        for (std::size_t m = 0; m < M; ++m) {
+            if (orderings[m] == Ordering::HIGHER)
+                point[m] = -point[m];
+        }
+        return point;
+    }
+
+    void evaluate() {
+        for (auto& member : members) {
+            if (!member.evaluated) {
+                member.objectives = evaluator(member.genome);
+                member.evaluated = true;
+            }
+        }
+    }
+
+    // Binary tournament on (rank, crowding) among the population
+    std::size_t tournament() const {
+        const auto a = utils::random_uint(PopSize);
+        const auto b = utils::random_uint(PopSize);
+        return fitter(members[a], members[b]) ? a : b;
+    }
+
+    static bool fitter(const Member& a, const Member& b) {
+        return a.rank < b.rank || (a.rank == b.rank && a.crowding > b.crowding);
+    }
+
+    // Move the fittest PopSize members to the front of 'members', recording
+    // their rank and crowding, and add the first front to the archive
+    void select() {
+        points.clear();
+        for (const auto& member : members) {
+            points.push_back(minimized(member.objectives));
+        }
+        const auto numFronts = pareto::sortFronts(points, rank, fronts, order);
+        // Before the first front may be cut to PopSize below
+        updateArchive();
+
+        survivors.clear();
+        for (std::size_t k = 0; k < numFronts && survivors.size() < PopSize;
+             ++k) {
+            auto& front = fronts[k];
+            pareto::crowding(points, front, distance, scratch);
+            if (survivors.size() + front.size() > PopSize) {
+                // Keep the least crowded of the last front admitted
+                const auto wanted = PopSize - survivors.size();
+                std::nth_element(front.begin(), front.begin() + wanted - 1,
+                                 front.end(),
+                                 [&](std::size_t a, std::size_t b) {
+                    return distance[a] > distance[b];
+                });
+                front.resize(wanted);
+            }
+            survivors.insert(survivors.end(), front.begin(), front.end());
+        }
+
+        for (auto i : survivors) {
+            members[i].rank = rank[i];
+            members[i].crowding = distance[i];
+        }
+
+        // Swap the survivors into place. The other members' genomes are
+        // retained past PopSize and overwritten by the next children.
+        kept.assign(members.size(), false);
+        for (auto i : survivors) {
+            kept[i] = true;
+        }
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            if (kept[i]) {
+                if (i != next)
+                    std::swap(members[i], members[next]);
+                ++next;
+            }
+        }
+    }
+
+    // Merge the members of the first front into the archive
+    void updateArchive() {
+        candidates.clear();
+        for (auto& solution : archive) {
+            candidates.push_back(std::move(solution));
+        }
+        for (auto i : fronts[0]) {
+            candidates.push_back(
+                Solution{members[i].genome, members[i].objectives});
+        }
+
+        archivePoints.clear();
+        for (const auto& candidate : candidates) {
+            archivePoints.push_back(minimized(candidate.objectives));
+        }
+        pareto::sortFronts(archivePoints, archiveRank, archiveFronts, order);
+
+        // The first front, without solutions with the same objectives
+        auto& front = archiveFronts[0];
+        std::sort(front.begin(), front.end(),
+                  [&](std::size_t a, std::size_t b) {
+            return archivePoints[a] < archivePoints[b];
+        });
+        front.erase(std::unique(front.begin(), front.end(),
+                                [&](std::size_t a, std::size_t b) {
+                        return archivePoints[a] == archivePoints[b];
+                    }),
+                    front.end());
+
+        // Keep the least crowded if the front does not fit, as in select
+        if (front.size() > archiveSize) {
+            pareto::crowding(archivePoints, front, archiveDistance, scratch);
+            std::nth_element(front.begin(), front.begin() + archiveSize,
+                             front.end(), [&](std::size_t a, std::size_t b) {
+                return archiveDistance[a] > archiveDistance[b];
+            });
+            front.resize(archiveSize);
+        }
+
+        archive.clear();
+        for (auto i : front) {
+            archive.push_back(std::move(candidates[i]));
+        }
+    }
+
+    std::vector<Member> members; // [0, PopSize) are the population
+    std::vector<Solution> archive;
+    std::size_t archiveSize = PopSize;
+
+    GeneratorType<Genome> generator;
+    MultiEvaluatorType<Genome, M> evaluator;
+    CrossoverIntoType<Genome> crossover;
+    MutatorType<Genome> mutator;
+
+    std::array<Ordering, M> orderings;
+    float mutationRate = 0.6f;
+
+    // Scratch space for selection, kept to avoid reallocating
+    std::vector<pareto::Point<M>> points, archivePoints;
+    std::vector<unsigned int> rank, archiveRank;
+    std::vector<std::vector<std::size_t>> fronts, archiveFronts;
+    std::vector<std::size_t> order, survivors, scratch;
+    std::vector<double> distance, archiveDistance;
+    std::vector<bool> kept;
+    std::vector<Solution> candidates;
+};
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef PARALLELEVALUATOR_H_
+#define PARALLELEVALUATOR_H_
+
+#include "cppEvolve/Population.hpp"
+#include "cppEvolve/ThreadPool.hpp"
+#include <vector>
+
+namespace evolve {
+
+/*!
+ * Declares how an evaluator may be used from several threads at once.
+ */
+enum class ThreadSafety {
+    /// The evaluator may be called concurrently; all workers share it
+    SHARED,
+
+    /// Each worker calls its own copy of the evaluator, so state held by the
+    /// function object (scratch buffers, counters) is never shared. State
+    /// outside the object, such as globals, must still be made thread safe
+    /// (e.g. thread_local) by the user.
+    PER_THREAD
+};
+
+/*!
+ * Scores every unevaluated member of a Population concurrently on a pool of
+ * worker threads. Individuals are handed out dynamically, so evaluators with
+ * uneven run time still keep all workers busy.
+ */
+template <typename Genome, typename Evaluator>
+class ParallelEvaluator {
+public:
+    /*!
+     * @param evaluator The fitness function
+     * @param workers The number of threads to use (0 for one per core)
+     * @param _safety Whether the workers share 'evaluator' or copy it
+     */
+    ParallelEvaluator(const Evaluator& evaluator, unsigned int workers = 0,
+                      ThreadSafety _safety = ThreadSafety::SHARED)
+        : pool(workers), safety(_safety) {
+        auto copies = (safety == ThreadSafety::PER_THREAD) ? pool.size() : 1;
+        evaluators.assign(copies, evaluator);
+    }
+
+    /*!
+     * Evaluate every individual whose cached fitness is stale. Returns the
+     * number of evaluations performed.
+     */
+    std::size_t evaluate(Population<Genome>& population) {
+        stale.clear();
+        for (std::size_t i = 0; i < population.size(); ++i) {
+            if (!population[i].evaluated)
+                stale.push_back(i);
+        }
+
+        pool.parallelFor(stale.size(), [&](unsigned int worker,
+                                           std::size_t i) {
+            auto& member = population[stale[i]];
+            const auto& evaluator =
+                evaluators[safety == ThreadSafety::PER_THREAD ? worker : 0];
+            member.fitness = evaluator(member.genome);
+            member.evaluated = true;
+        });
+        return stale.size();
+    }
+
+    /// The number of worker threads, including the calling thread
+    unsigned int getWorkers() const { return pool.size(); }
+
+private:
+    utils::ThreadPool pool;
+    ThreadSafety safety;
+    std::vector<Evaluator> evaluators;
+    std::vector<std::size_t> stale;
+};
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef PARETO_H_
+#define PARETO_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace evolve {
+
+/*!
+ * Pareto dominance, non-dominated sorting and crowding distance for
+ * multi-objective optimization (see NSGA2). Every objective is minimized;
+ * NSGA2 negates the objectives which are to be maximized before using them.
+ */
+namespace pareto {
+
+template <std::size_t M>
+using Point = std::array<double, M>;
+
+/// True if 'a' is no worse than 'b' in every objective and better in one
+template <std::size_t M>
+bool dominates(const Point<M>& a, const Point<M>& b) {
+    bool better = false;
+    for (std::size_t m = 0; m < M; ++m) {
+        if (b[m] < a[m])
+            return false;
+        better = better || a[m] < b[m];
+    }
+    return better;
+}
+
+namespace details {
+
+// With two objectives, the members of a front sorted by the first objective
+// are sorted in reverse by the second, so the last member added dominates
+// the point if any member does
+template <std::size_t M>
+bool dominatedBy(const std::vector<Point<M>>& points,
+                 const std::vector<std::size_t>& front, const Point<M>& point,
+                 std::true_type) {
+    return dominates(points[front.back()], point);
+}
+
+// Otherwise compare with each member, latest first, as the latest members
+// are the most likely to dominate it
+template <std::size_t M>
+bool dominatedBy(const std::vector<Point<M>>& points,
+                 const std::vector<std::size_t>& front, const Point<M>& point,
+                 std::false_type) {
+    for (auto i = front.size(); i-- > 0;) {
+        if (dominates(points[front[i]], point))
+            return true;
+    }
+    return false;
+}
+}
+
+/*!
+ * Non-dominated sorting. On return fronts[k] holds the indices of the points
+ * in front k, the first front being the points no other point dominates, and
+ * rank[i] is the front of point i. Returns the number of fronts. 'fronts' may
+ * be reused between calls, in which case its vectors keep their storage.
+ *
+ * Uses Efficient Non-dominated Sort with binary search (ENS-BS): the points
+ * are visited in lexicographic order, so none is dominated by a later one,
+ * and each is placed in the first front with no member dominating it, found
+ * by binary search over the fronts. With two objectives only one member of
+ * a front need be checked, so the sort is O(N log N); with more it is
+ * O(M N^2) in the worst case but much faster in practice.
+ */
+template <std::size_t M>
+std::size_t sortFronts(const std::vector<Point<M>>& points,
+                       std::vector<unsigned int>& rank,
+                       std::vector<std::vector<std::size_t>>& fronts,
+                       std::vector<std::size_t>& order) {
+    order.resize(points.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return points[a] < points[b];
+    });
+
+    rank.resize(points.size());
+    std::size_t count = 0;
+    for (auto index : order) {
+        const auto& point = points[index];
+        std::size_t low = 0, high = count;
+        while (low < high) {
+            const auto middle = (low + high) / 2;
+            if (details::dominatedBy(points, fronts[middle], point,
+                                     std::integral_constant<bool, M == 2>{}))
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        if (low == count) {
+            if (fronts.size() == count)
+                fronts.emplace_back();
+            fronts[count++].clear();
+        }
+        fronts[low].push_back(index);
+        rank[index] = low;
+    }
+    return count;
+}
+
+/// As above, with scratch space of its own
+template <std::size_t M>
+std::size_t sortFronts(const std::vector<Point<M>>& points,
+                       std::vector<unsigned int>& rank,
+                       std::vector<std::vector<std::size_t>>& fronts) {
+    std::vector<std::size_t> order;
+    return sortFronts(points, rank, fronts, order);
+}
+
+/*!
+ * Set distance[i] to the crowding distance of each point i in 'front': the
+ * sum over the objectives of the distance between its neighbours in the
+ * front, relative to the extent of the front. The extreme points of each
+ * objective have infinite distance. 'order' is scratch space.
+ */
+template <std::size_t M>
+void crowding(const std::vector<Point<M>>& points,
+              const std::vector<std::size_t>& front,
+              std::vector<double>& distance, std::vector<std::size_t>& order) {
+    if (distance.size() < points.size())
+        distance.resize(points.size());
+    for (auto i : front) {
+        distance[i] = 0;
+    }
+    if (front.size() < 3) {
+        for (auto i : front) {
+            distance[i] = std::numeric_limits<double>::infinity();
+        }
+        return;
+    }
+
+    order = front;
+    for (std::size_t m = 0; m < M; ++m) {
+        std::sort(order.begin(), order.end(),
+                  [&](std::size_t a, std::size_t b) {
+            return points[a][m] < points[b][m];
+        });
+        const auto lowest = points[order.front()][m];
+        const auto extent = points[order.back()][m] - lowest;
+        distance[order.front()] = distance[order.back()] =
+            std::numeric_limits<double>::infinity();
+        if (extent <= 0)
+            continue;
+        for (std::size_t k = 1; k + 1 < order.size(); ++k) {
+            distance[order[k]] +=
+                (points[order[k + 1]][m] - points[order[k - 1]][m]) / extent;
+        }
+    }
+}
+}
+}
+
+#endif
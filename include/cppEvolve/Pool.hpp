@@ -0,0 +1,213 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace evolve {
+namespace utils {
+
+/*!
+ * Thread caching free lists for small objects, used for the nodes of
+ * tree::Tree. Blocks are grouped in size classes of 16 bytes up to 256 bytes;
+ * larger requests go to the global allocator. Each thread allocates from and
+ * frees to its own lists without locking. Lists which grow too long, and the
+ * lists of a thread which exits, are handed to a shared depot from which
+ * other threads refill. Memory obtained for the pool is kept for reuse and
+ * never returned to the system.
+ *
+ * Define CPPEVOLVE_NO_POOL to use the global allocator instead.
+ */
+namespace pool {
+namespace details {
+
+const std::size_t granularity = 16;
+const std::size_t numClasses = 16;
+const std::size_t chunkSize = 64 * 1024;
+const std::size_t batchSize = 64;
+const std::size_t maxCached = 4 * batchSize;
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+inline std::size_t sizeClass(std::size_t size) {
+    return (size + granularity - 1) / granularity - 1;
+}
+
+// Blocks shared between threads. Never destroyed, as blocks handed out by it
+// may be freed during static destruction.
+class Depot {
+public:
+    static Depot& instance() {
+        static Depot* depot = new Depot;
+        return *depot;
+    }
+
+    // Move up to batchSize blocks of class 'c' to 'head', carving a new chunk
+    // if the depot is empty. Returns the number of blocks moved.
+    std::size_t take(std::size_t c, FreeBlock*& head) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!lists[c]) {
+            carve(c);
+        }
+        std::size_t count = 0;
+        while (lists[c] && count < batchSize) {
+            auto block = lists[c];
+            lists[c] = block->next;
+            block->next = head;
+            head = block;
+            ++count;
+        }
+        return count;
+    }
+
+    // Take the whole list starting at 'head' and ending at 'tail'
+    void give(std::size_t c, FreeBlock* head, FreeBlock* tail) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tail->next = lists[c];
+        lists[c] = head;
+    }
+
+private:
+    void carve(std::size_t c) {
+        const auto size = (c + 1) * granularity;
+        auto chunk = static_cast<char*>(::operator new(chunkSize));
+        chunks.push_back(chunk);
+        for (std::size_t offset = 0; offset + size <= chunkSize;
+             offset += size) {
+            auto block = reinterpret_cast<FreeBlock*>(chunk + offset);
+            block->next = lists[c];
+            lists[c] = block;
+        }
+    }
+
+    std::mutex mutex;
+    FreeBlock* lists[numClasses] = {};
+    std::vector<char*> chunks;
+};
+
+// The calling thread's free lists. Trivially destructible, so that blocks
+// freed during the thread's exit (after its Reaper ran) can still be handled.
+struct ThreadCache {
+    FreeBlock* lists[numClasses];
+    std::size_t counts[numClasses];
+    bool exited;
+
+    void* allocate(std::size_t c) {
+        if (!lists[c]) {
+            counts[c] += Depot::instance().take(c, lists[c]);
+        }
+        auto block = lists[c];
+        lists[c] = block->next;
+        --counts[c];
+        return block;
+    }
+
+    void deallocate(void* p, std::size_t c) {
+        auto block = static_cast<FreeBlock*>(p);
+        block->next = lists[c];
+        lists[c] = block;
+        if (++counts[c] > maxCached || exited) {
+            release(c, exited ? counts[c] : batchSize);
+        }
+    }
+
+    // Hand 'count' blocks of class 'c' back to the depot
+    void release(std::size_t c, std::size_t count) {
+        if (count == 0)
+            return;
+        auto head = lists[c];
+        auto tail = head;
+        for (std::size_t i = 1; i < count; ++i) {
+            tail = tail->next;
+        }
+        lists[c] = tail->next;
+        counts[c] -= count;
+        Depot::instance().give(c, head, tail);
+    }
+};
+
+// Returns the blocks of an exiting thread to the depot
+struct Reaper {
+    explicit Reaper(ThreadCache& _cache) : cache(_cache) {}
+
+    ~Reaper() {
+        for (std::size_t c = 0; c < numClasses; ++c) {
+            cache.release(c, cache.counts[c]);
+        }
+        cache.exited = true;
+    }
+
+    ThreadCache& cache;
+};
+
+inline ThreadCache& cache() {
+    thread_local ThreadCache c{};
+    thread_local Reaper reaper(c);
+    (void)reaper;
+    return c;
+}
+}
+
+/// Allocate 'size' bytes from the calling thread's free lists
+inline void* allocate(std::size_t size) {
+#ifndef CPPEVOLVE_NO_POOL
+    const auto c = details::sizeClass(size);
+    if (size != 0 && c < details::numClasses) {
+        return details::cache().allocate(c);
+    }
+#endif
+    return ::operator new(size);
+}
+
+/// Free a block returned by allocate. 'size' must be the size requested.
+inline void deallocate(void* p, std::size_t size) {
+#ifndef CPPEVOLVE_NO_POOL
+    const auto c = details::sizeClass(size);
+    if (size != 0 && c < details::numClasses) {
+        details::cache().deallocate(p, c);
+        return;
+    }
+#else
+    (void)size;
+#endif
+    ::operator delete(p);
+}
+}
+
+/*!
+ * A standard allocator drawing from the pool, used for the child lists of
+ * tree nodes.
+ */
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(pool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) { pool::deallocate(p, n * sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) {
+    return false;
+}
+}
+}
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef POPULATION_H_
+#define POPULATION_H_
+
+#include "cppEvolve/utils.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <utility>
+
+namespace evolve {
+
+/*!
+ * A member of a Population: the genome together with its cached fitness.
+ * The fitness is only meaningful while 'evaluated' is true; anything which
+ * changes the genome (crossover, mutation) must call invalidate.
+ */
+template <typename Genome>
+struct Individual {
+    Individual() = default;
+    Individual(const Genome& g) : genome(g) {}
+    Individual(Genome&& g) : genome(std::move(g)) {}
+
+    /// Mark the cached fitness as stale
+    void invalidate() { evaluated = false; }
+
+    Genome genome{};
+    double fitness = 0;
+    bool evaluated = false;
+};
+
+/*!
+ * The population of a GA. Each genome is stored alongside its fitness so that
+ * an individual is evaluated exactly once between changes, no matter how many
+ * times the selector or the GA inspects its score.
+ *
+ * Removing members does not destroy them: their slots are retained past the
+ * end of the population, and append() hands them out again so that new
+ * members can be written over genomes which already own storage. keep()
+ * rebuilds the population in a second buffer which is then swapped with the
+ * first. Once both buffers have grown to the population size, generations
+ * are produced without allocating genomes.
+ *
+ * Genomes held by pointer are owned by the population and deleted with it.
+ */
+template <typename Genome>
+class Population {
+public:
+    using value_type = Individual<Genome>;
+    using iterator = typename std::vector<Individual<Genome>>::iterator;
+    using const_iterator =
+        typename std::vector<Individual<Genome>>::const_iterator;
+
+    Population() = default;
+
+    Population(const Population& other) { *this = other; }
+
+    Population(Population&& other) { *this = std::move(other); }
+
+    Population& operator=(const Population& other) {
+        if (this != &other) {
+            clear();
+            for (const auto& member : other) {
+                auto& slot = append();
+                utils::copyInto(slot.genome, member.genome);
+                slot.fitness = member.fitness;
+                slot.evaluated = member.evaluated;
+            }
+        }
+        return *this;
+    }
+
+    Population& operator=(Population&& other) {
+        if (this != &other) {
+            clear();
+            releaseSpares();
+            members.swap(other.members);
+            buffer.swap(other.buffer);
+            std::swap(live, other.live);
+        }
+        return *this;
+    }
+
+    ~Population() {
+        clear();
+        releaseSpares();
+    }
+
+    /*!
+     * Add a new (unevaluated) slot to the end of the population and return
+     * it. The slot's genome may be a retained genome of a former member (or
+     * null for pointer genomes), meant to be overwritten in place.
+     */
+    Individual<Genome>& append() {
+        if (live == members.size()) {
+            members.emplace_back();
+        }
+        auto& slot = members[live++];
+        slot.invalidate();
+        return slot;
+    }
+
+    /// Add a new (unevaluated) individual to the population
+    void push_back(const Genome& g) {
+        auto& slot = append();
+        utils::release(slot.genome);
+        slot.genome = g;
+    }
+
+    void push_back(Genome&& g) {
+        auto& slot = append();
+        utils::release(slot.genome);
+        slot.genome = std::move(g);
+    }
+
+    void push_back(Individual<Genome>&& member) {
+        auto& slot = append();
+        utils::release(slot.genome);
+        slot = std::move(member);
+    }
+
+    /*!
+     * Evaluate every individual whose cached fitness is stale. Returns the
+     * number of calls made to the evaluator.
+     */
+    template <typename Evaluator>
+    std::size_t evaluate(const Evaluator& evaluator) {
+        std::size_t count = 0;
+        for (auto& member : *this) {
+            if (!member.evaluated) {
+                member.fitness = evaluator(member.genome);
+                member.evaluated = true;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /// True if every individual has an up to date fitness
+    bool isEvaluated() const {
+        for (const auto& member : *this) {
+            if (!member.evaluated)
+                return false;
+        }
+        return true;
+    }
+
+    /*!
+     * Compute the mean and standard deviation of the fitness of the
+     * evaluated individuals
+     */
+    void statistics(double& mean, double& deviation) const {
+        double sum = 0, squares = 0;
+        std::size_t count = 0;
+        for (const auto& member : *this) {
+            if (member.evaluated) {
+                sum += member.fitness;
+                squares += member.fitness * member.fitness;
+                ++count;
+            }
+        }
+        mean = count ? sum / count : 0;
+        deviation = count ? std::sqrt(std::max(0.0, squares / count -
+                                                        mean * mean))
+                          : 0;
+    }
+
+    /*!
+     * Index of the fittest evaluated individual under 'ord', or size() if no
+     * individual has been evaluated.
+     */
+    std::size_t fittest(Ordering ord) const {
+        auto best = live;
+        for (std::size_t i = 0; i < live; ++i) {
+            if (members[i].evaluated &&
+                (best == live ||
+                 utils::better(ord, members[i].fitness, members[best].fitness)))
+                best = i;
+        }
+        return best;
+    }
+
+    /*!
+     * Indices of up to 'count' evaluated individuals, fittest first under
+     * 'ord'. Pass utils::reversed(ord) to get the least fit instead.
+     */
+    std::vector<std::size_t> ranked(Ordering ord, std::size_t count) const {
+        std::vector<std::size_t> indices;
+        for (std::size_t i = 0; i < live; ++i) {
+            if (members[i].evaluated)
+                indices.push_back(i);
+        }
+        count = std::min(count, indices.size());
+        std::partial_sort(indices.begin(), indices.begin() + count,
+                          indices.end(), [&](std::size_t a, std::size_t b) {
+            return utils::better(ord, members[a].fitness, members[b].fitness);
+        });
+        indices.resize(count);
+        return indices;
+    }
+
+    Individual<Genome>& operator[](std::size_t i) {
+        assert(i < live);
+        return members[i];
+    }
+    const Individual<Genome>& operator[](std::size_t i) const {
+        assert(i < live);
+        return members[i];
+    }
+
+    iterator begin() { return members.begin(); }
+    iterator end() { return members.begin() + live; }
+    const_iterator begin() const { return members.begin(); }
+    const_iterator end() const { return members.begin() + live; }
+
+    /*!
+     * Remove the members in [first, last). Their slots are retained for
+     * reuse by append().
+     */
+    iterator erase(iterator first, iterator last) {
+        const auto removed = std::distance(first, last);
+        std::rotate(first, last, end());
+        live -= removed;
+        return first;
+    }
+
+    /*!
+     * Reorder the population so that member i is the former member
+     * indices[i], discarding every member not listed. An index may be listed
+     * more than once, in which case the member is copied (pointer genomes
+     * are cloned) along with its cached fitness.
+     *
+     * The new population is built in a second buffer whose slots are
+     * overwritten in place, and the buffers are then swapped.
+     */
+    void keep(const std::vector<std::size_t>& indices) {
+        const auto unused = live;
+        positions.assign(live, unused);
+        if (buffer.size() < indices.size()) {
+            buffer.resize(indices.size());
+        }
+
+        for (std::size_t k = 0; k < indices.size(); ++k) {
+            const auto index = indices[k];
+            assert(index < live);
+            if (positions[index] == unused) {
+                positions[index] = k;
+                std::swap(buffer[k], members[index]);
+            } else {
+                const auto& original = buffer[positions[index]];
+                utils::copyInto(buffer[k].genome, original.genome);
+                buffer[k].fitness = original.fitness;
+                buffer[k].evaluated = original.evaluated;
+            }
+        }
+
+        members.swap(buffer);
+        live = indices.size();
+    }
+
+    /*!
+     * Keep a discarded genome for later reuse, if there is a free slot in the
+     * reserved storage. Otherwise it is released, since growing the storage
+     * would invalidate references to the members. The population owns it.
+     */
+    void recycle(Genome&& genome) {
+        if (members.size() < members.capacity()) {
+            members.emplace_back(std::move(genome));
+        } else {
+            utils::release(genome);
+        }
+    }
+
+    /*!
+     * Take a retained genome, or a value initialized one (nullptr for pointer
+     * genomes) if there are none.
+     */
+    Genome reuse() {
+        Genome genome{};
+        if (members.size() > live) {
+            genome = std::move(members.back().genome);
+            members.pop_back();
+        } else if (!buffer.empty()) {
+            genome = std::move(buffer.back().genome);
+            buffer.pop_back();
+        }
+        return genome;
+    }
+
+    /// The number of retained genomes available for reuse
+    std::size_t numSpares() const {
+        return members.size() - live + buffer.size();
+    }
+
+    /// Destroy all retained genomes
+    void releaseSpares() {
+        for (auto i = live; i < members.size(); ++i) {
+            utils::release(members[i].genome);
+        }
+        for (auto& slot : buffer) {
+            utils::release(slot.genome);
+        }
+        members.resize(live);
+        buffer.clear();
+    }
+
+    std::size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+    std::size_t capacity() const { return members.capacity(); }
+
+    /// Reserve storage for 'n' members in both buffers
+    void reserve(std::size_t n) {
+        members.reserve(n);
+        buffer.reserve(n);
+        positions.reserve(n);
+    }
+
+    /// Remove every member, retaining the slots for reuse
+    void clear() { erase(begin(), end()); }
+
+private:
+    std::vector<Individual<Genome>> members; // [0, live) are the population
+    std::vector<Individual<Genome>> buffer;  // second buffer used by keep
+    std::vector<std::size_t> positions;      // scratch space for keep
+    std::size_t live = 0;
+};
+}
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace evolve {
+namespace utils {
+
+/*!
+ * The xoshiro256** generator by Blackman and Vigna. It satisfies the
+ * UniformRandomBitGenerator requirements, so it may also be used with the
+ * <random> distributions.
+ */
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t value = 0) { seed(value); }
+
+    /// Reset the state, expanding 'value' with splitmix64
+    void seed(std::uint64_t value) {
+        for (auto& word : state) {
+            value += 0x9e3779b97f4a7c15ULL;
+            auto z = value;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()() {
+        const auto result = rotl(state[1] * 5, 7) * 9;
+        const auto t = state[1] << 17;
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+
+        return result;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state[4];
+};
+
+/// The engine type used by the library
+using Engine = Xoshiro256;
+
+namespace details {
+
+// Streams are numbered in the order threads first draw a random number, so a
+// single threaded program is reproducible without calling seed.
+inline std::uint64_t nextStream() {
+    static std::atomic<std::uint64_t> streams{0};
+    return streams++;
+}
+}
+
+/*!
+ * The calling thread's engine. Every thread has its own engine, so the
+ * built-in crossovers, mutators and factories may be used concurrently. For
+ * reproducible multithreaded runs, each thread should call seed with a value
+ * derived from its role (e.g. its island number) before drawing.
+ */
+inline Engine& engine() {
+    thread_local Engine e{details::nextStream()};
+    return e;
+}
+
+/// Seed the calling thread's engine
+inline void seed(std::uint64_t value) { engine().seed(value); }
+
+/*!
+ * Generate a random number uniformly distributed in [0, upper) from 'e'
+ * using Lemire's multiply-shift method, which only divides on the rare
+ * rejection path.
+ */
+template <typename E>
+std::uint64_t bounded(E& e, std::uint64_t upper) {
+    assert(upper > 0);
+#if defined(__SIZEOF_INT128__)
+    using uint128 = unsigned __int128;
+    auto m = static_cast<uint128>(e()) * upper;
+    auto low = static_cast<std::uint64_t>(m);
+    if (low < upper) {
+        const auto threshold = (0 - upper) % upper;
+        while (low < threshold) {
+            m = static_cast<uint128>(e()) * upper;
+            low = static_cast<std::uint64_t>(m);
+        }
+    }
+    return static_cast<std::uint64_t>(m >> 64);
+#else
+    const auto threshold = (0 - upper) % upper;
+    for (;;) {
+        auto x = e();
+        if (x >= threshold)
+            return x % upper;
+    }
+#endif
+}
+
+/*
+ * Generate a random number uniformly distributed in [lower, upper)
+ */
+inline std::size_t random_uint(std::size_t lower, std::size_t upper) {
+    return lower + bounded(engine(), upper - lower);
+}
+
+inline std::size_t random_uint(std::size_t upper) {
+    return bounded(engine(), upper);
+}
+
+/*!
+ * Fill [first, last) with random numbers uniformly distributed in
+ * [0, upper). Cheaper than repeated calls to random_uint as the engine is
+ * looked up once.
+ */
+template <typename OutputIt>
+void random_uints(std::size_t upper, OutputIt first, OutputIt last) {
+    auto& e = engine();
+    for (; first != last; ++first) {
+        *first = bounded(e, upper);
+    }
+}
+
+/// Generate 64 uniformly random bits
+inline std::uint64_t random_bits() { return engine()(); }
+
+/// Generate a random double uniformly distributed in [0, 1)
+inline double random_real() {
+    return (engine()() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/// Generate a standard normally distributed double
+inline double random_normal() {
+    const auto u = 1 - random_real();
+    return std::sqrt(-2 * std::log(u)) * std::cos(6.283185307179586 *
+                                                  random_real());
+}
+
+/*!
+ * Fill [first, last) with standard normally distributed doubles. The
+ * uniform numbers are drawn first and then transformed in pairs with the
+ * Box-Muller method, in a loop free of calls to the engine.
+ */
+template <typename RandomIt>
+void random_normals(RandomIt first, RandomIt last) {
+    auto& e = engine();
+    for (auto it = first; it != last; ++it) {
+        *it = (e() >> 11) * (1.0 / 9007199254740992.0);
+    }
+    const auto count = last - first;
+    for (decltype(last - first) i = 0; i + 1 < count; i += 2) {
+        const auto r = std::sqrt(-2 * std::log(1 - first[i]));
+        const auto theta = 6.283185307179586 * first[i + 1];
+        first[i] = r * std::cos(theta);
+        first[i + 1] = r * std::sin(theta);
+    }
+    if (count % 2) {
+        last[-1] = random_normal();
+    }
+}
+
+/*!
+ * Draws the gaps between successes of independent trials with success
+ * probability 'p', so that selecting each of n items with probability p
+ * takes O(pn) random numbers rather than n.
+ */
+class GeometricSkip {
+public:
+    explicit GeometricSkip(double p) : scale(1 / std::log1p(-p)) {
+        assert(p > 0 && p < 1);
+    }
+
+    /// The number of failures before the next success
+    std::size_t operator()() const {
+        const auto skip = std::floor(std::log(1 - random_real()) * scale);
+        const double cap = std::numeric_limits<std::size_t>::max() / 2;
+        return static_cast<std::size_t>(std::min(skip, cap));
+    }
+
+private:
+    double scale;
+};
+
+/*!
+ * Samples indices in proportion to a set of non-negative weights in O(1)
+ * after an O(N) build, using Vose's alias method.
+ */
+class AliasTable {
+public:
+    AliasTable() = default;
+
+    template <typename InputIt>
+    AliasTable(InputIt first, InputIt last) {
+        build(first, last);
+    }
+
+    /// (Re)build the table from the weights in [first, last)
+    template <typename InputIt>
+    void build(InputIt first, InputIt last) {
+        probability.assign(first, last);
+        const auto n = probability.size();
+        alias.assign(n, 0);
+
+        double total = 0;
+        for (auto weight : probability) {
+            assert(weight >= 0);
+            total += weight;
+        }
+
+        small.clear();
+        large.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            // Scale so that the mean weight is 1; all zero is uniform
+            probability[i] = (total > 0) ? probability[i] * n / total : 1;
+            (probability[i] < 1 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            auto less = small.back();
+            auto more = large.back();
+            small.pop_back();
+            alias[less] = more;
+            probability[more] -= 1 - probability[less];
+            if (probability[more] < 1) {
+                large.pop_back();
+                small.push_back(more);
+            }
+        }
+        // Whatever remains is 1 up to rounding error
+        for (auto i : small)
+            probability[i] = 1;
+        for (auto i : large)
+            probability[i] = 1;
+    }
+
+    /// Draw an index from the calling thread's engine
+    std::size_t operator()() const {
+        auto column = random_uint(probability.size());
+        return (random_real() < probability[column]) ? column : alias[column];
+    }
+
+    std::size_t size() const { return probability.size(); }
+
+private:
+    std::vector<double> probability;
+    std::vector<std::size_t> alias;
+    std::vector<std::size_t> small;
+    std::vector<std::size_t> large;
+};
+}
+}
+
+#endif
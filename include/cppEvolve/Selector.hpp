@@ -3,87 +3,318 @@
 #define SELECTOR_H_
 
 #include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
 #include <cassert>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <ratio>
 #include <type_traits>
 
 namespace evolve {
 
 /*!
- * The namespace for the built-in population selectors.
+ * The namespace for the built-in population selectors. Selectors operate on
+ * the cached fitness of each individual, so the population must have been
+ * evaluated before the selector is called.
  */
 namespace selector {
 namespace details {
 
-// Sort the population based on the value of Ordering
+// Compare individuals by cached fitness according to Ordering
 // (saves the user from writing a lambda)
 template <typename Genome>
-void orderedSort(std::vector<Genome>& population,
-                 const std::function<float(const Genome&)>& evaluator,
-                 Ordering Ord) {
-
-    if (Ord == Ordering::LOWER) {
-        std::sort(population.begin(), population.end(),
-                  [&evaluator](const Genome& left, const Genome& right) {
-            return evaluator(left) < evaluator(right);
-        });
-    } else {
-        std::sort(population.begin(), population.end(),
-                  [&evaluator](const Genome& left, const Genome& right) {
-            return evaluator(left) > evaluator(right);
-        });
+struct FitterThan {
+    Ordering ord;
+
+    bool operator()(const Individual<Genome>& left,
+                    const Individual<Genome>& right) const {
+        return utils::better(ord, left.fitness, right.fitness);
+    }
+};
+
+// Per-thread working storage, so that selectors do not allocate once it has
+// grown to the population size
+struct Scratch {
+    std::vector<double> weights;
+    std::vector<std::size_t> indices;
+    std::vector<std::size_t> picks;
+    utils::AliasTable table;
+};
+
+inline Scratch& scratch() {
+    thread_local Scratch s;
+    return s;
+}
+
+// Fitness shifted so that the least fit individual has weight 0 (windowing),
+// which allows negative scores and minimization
+template <typename Genome>
+void windowedWeights(const Population<Genome>& population, Ordering ord,
+                     std::vector<double>& weights) {
+    auto worst = population[0].fitness;
+    for (const auto& member : population) {
+        if (utils::better(ord, worst, member.fitness))
+            worst = member.fitness;
+    }
+
+    weights.clear();
+    for (const auto& member : population) {
+        weights.push_back(std::abs(member.fitness - worst));
+    }
+}
+
+// Weights for rank based selection given the fitness rank of each member
+// (0 is the fittest) and a function from rank to weight
+template <typename Genome, typename WeightFunc>
+void rankWeights(const Population<Genome>& population, Ordering ord,
+                 WeightFunc weight, std::vector<double>& weights) {
+    auto& order = scratch().indices;
+    order.resize(population.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return utils::better(ord, population[a].fitness,
+                             population[b].fitness);
+    });
+
+    weights.resize(population.size());
+    for (std::size_t rank = 0; rank < order.size(); ++rank) {
+        weights[order[rank]] = weight(rank);
+    }
+}
+
+// Stochastic universal sampling: Num equally spaced pointers with a single
+// random offset over the cumulative weights. O(N + Num).
+inline void universalSample(const std::vector<double>& weights,
+                            std::size_t num, std::vector<std::size_t>& picks) {
+    double total = 0;
+    for (auto weight : weights)
+        total += weight;
+
+    picks.clear();
+    if (total <= 0) {
+        // Every weight is zero, so every member is equally likely
+        for (std::size_t i = 0; i < num; ++i)
+            picks.push_back(utils::random_uint(weights.size()));
+        return;
+    }
+
+    const auto spacing = total / num;
+    auto pointer = utils::random_real() * spacing;
+    double cumulative = weights[0];
+    std::size_t i = 0;
+    while (picks.size() < num) {
+        while (cumulative <= pointer && i + 1 < weights.size()) {
+            cumulative += weights[++i];
+        }
+        picks.push_back(i);
+        pointer += spacing;
     }
 }
 
-// Top selector for the case that Genome is not a pointer type
-template <typename Genome, size_t Num, Ordering Ord>
-void topHelper(std::vector<Genome>& population,
-               const std::function<float(const Genome&)>& evaluator,
-               std::false_type) {
-    orderedSort(population, evaluator, Ord);
+} // end detail namespace
+
+/*!
+ * Select the top 'num' individuals from the population. If genome is a
+ * pointer, the individuals not selected are kept as spares for reuse.
+ * Ordering determines whether HIGHER or LOWER values are considered more fit.
+ *
+ * The survivors are found by a partial selection (std::nth_element) on the
+ * cached fitness, which is O(N) on average; they are not left in any
+ * particular order. Use topSorted if the order matters.
+ */
+template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER>
+void top(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    assert(population.size() >= Num);
+    assert(population.isEvaluated());
 
     auto location = population.begin();
     std::advance(location, Num);
 
+    if (location != population.end()) {
+        std::nth_element(population.begin(), location - 1, population.end(),
+                         details::FitterThan<Genome>{Order});
+    }
     population.erase(location, population.end());
 }
 
-// Top selector for the case that Genome is a pointer type
-// (i.e. for Tree)
-template <typename Genome, size_t Num, Ordering Ord>
-void topHelper(std::vector<Genome>& population,
-               const std::function<float(const Genome&)>& evaluator,
-               std::true_type) {
-    orderedSort(population, evaluator, Ord);
+/*!
+ * As top, but the survivors are left fittest first. Individuals of equal
+ * fitness keep their relative order, both when ranked and when deciding which
+ * of them survive. Costs O(N + Num log Num).
+ */
+template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER>
+void topSorted(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    assert(population.size() >= Num);
+    assert(population.isEvaluated());
 
-    auto location = population.begin();
-    std::advance(location, Num);
+    // Find the fitness of the Num-th fittest individual
+    auto& scores = details::scratch().weights;
+    scores.clear();
+    for (const auto& member : population) {
+        scores.push_back(member.fitness);
+    }
+    auto threshold = scores.begin() + (Num - 1);
+    std::nth_element(scores.begin(), threshold, scores.end(),
+                     [](double a, double b) {
+        return utils::better(Order, a, b);
+    });
 
-    // Assume the pointer points to dynamically allocated memory
-    for (auto iter = location; iter != population.end(); ++iter) {
-        delete *iter;
+    // Everything fitter than the threshold survives, then the earliest of the
+    // individuals tied with it
+    std::size_t ties = Num;
+    for (auto score : scores) {
+        if (utils::better(Order, score, *threshold))
+            --ties;
     }
 
-    population.erase(location, population.end());
+    auto& survivors = details::scratch().picks;
+    survivors.clear();
+    for (std::size_t i = 0; i < population.size(); ++i) {
+        const auto fitness = population[i].fitness;
+        if (utils::better(Order, fitness, *threshold)) {
+            survivors.push_back(i);
+        } else if (ties > 0 && !utils::better(Order, *threshold, fitness)) {
+            survivors.push_back(i);
+            --ties;
+        }
+    }
+
+    std::stable_sort(survivors.begin(), survivors.end(),
+                     [&](std::size_t a, std::size_t b) {
+        return utils::better(Order, population[a].fitness,
+                             population[b].fitness);
+    });
+    population.keep(survivors);
 }
 
-} // end detail namespace
+/*!
+ * k-way tournament selection: the population is replaced by the winners of
+ * Num tournaments, each between Size members drawn at random (with
+ * replacement). Costs O(Num * Size). Larger tournaments increase the
+ * selection pressure.
+ */
+template <typename Genome, size_t Num, size_t Size = 2,
+          Ordering Order = Ordering::HIGHER>
+void tournament(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    static_assert(Size >= 1, "A tournament needs at least 1 entrant");
+    assert(population.isEvaluated());
+
+    auto& winners = details::scratch().picks;
+    winners.clear();
+    for (std::size_t i = 0; i < Num; ++i) {
+        auto winner = utils::random_uint(population.size());
+        for (std::size_t j = 1; j < Size; ++j) {
+            auto entrant = utils::random_uint(population.size());
+            if (utils::better(Order, population[entrant].fitness,
+                              population[winner].fitness))
+                winner = entrant;
+        }
+        winners.push_back(winner);
+    }
+    population.keep(winners);
+}
 
 /*!
- * Select the top 'num' individuals from the population. If genome is a
- * pointer, the individuals not selected are deleted. Ordering determines
- * whether HIGHER or LOWER values are considered more fit.
+ * Fitness proportional (roulette wheel) selection of Num members with
+ * replacement, sampled from an alias table in O(N + Num). Fitness is
+ * windowed: each member's weight is its distance from the least fit member,
+ * so scores may be negative and Ordering::LOWER is supported.
  */
 template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER>
-void top(std::vector<Genome>& population,
-         const std::function<float(const Genome&)>& evaluator) {
+void roulette(Population<Genome>& population) {
     static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
                             "population");
-    assert(population.size() >= Num);
-    using is_pointer_t = typename std::is_pointer<Genome>::type;
-    details::topHelper<Genome, Num, Order>(population, evaluator,
-                                           is_pointer_t{});
+    assert(population.isEvaluated());
+
+    auto& weights = details::scratch().weights;
+    details::windowedWeights(population, Order, weights);
+    auto& table = details::scratch().table;
+    table.build(weights.begin(), weights.end());
+
+    auto& picks = details::scratch().picks;
+    picks.clear();
+    for (std::size_t i = 0; i < Num; ++i) {
+        picks.push_back(table());
+    }
+    population.keep(picks);
+}
+
+/*!
+ * Stochastic universal sampling: fitness proportional selection of Num
+ * members using evenly spaced pointers, which guarantees each member
+ * between the floor and ceiling of its expected number of copies. O(N + Num).
+ * Fitness is windowed as in roulette.
+ */
+template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER>
+void stochasticUniversal(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    assert(population.isEvaluated());
+
+    auto& weights = details::scratch().weights;
+    auto& picks = details::scratch().picks;
+    details::windowedWeights(population, Order, weights);
+    details::universalSample(weights, Num, picks);
+    population.keep(picks);
+}
+
+/*!
+ * Linear rank selection of Num members by stochastic universal sampling. The
+ * fittest member is expected to be selected Pressure times as often as
+ * average and the least fit 2 - Pressure times, with Pressure in [1, 2]
+ * given as a std::ratio. O(N log N) for the ranking.
+ */
+template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER,
+          typename Pressure = std::ratio<3, 2>>
+void linearRank(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    static_assert(Pressure::num >= Pressure::den &&
+                      Pressure::num <= 2 * Pressure::den,
+                  "Linear rank pressure must be in [1, 2]");
+    assert(population.isEvaluated());
+
+    const double pressure = static_cast<double>(Pressure::num) / Pressure::den;
+    const double last = population.size() > 1 ? population.size() - 1 : 1;
+    auto& weights = details::scratch().weights;
+    auto& picks = details::scratch().picks;
+    details::rankWeights(population, Order, [&](std::size_t rank) {
+        return (2 - pressure) + 2 * (pressure - 1) * (last - rank) / last;
+    }, weights);
+    details::universalSample(weights, Num, picks);
+    population.keep(picks);
+}
+
+/*!
+ * Exponential rank selection of Num members by stochastic universal
+ * sampling. The member of rank r (0 is the fittest) has weight Base^r, with
+ * Base in (0, 1) given as a std::ratio. O(N log N) for the ranking.
+ */
+template <typename Genome, size_t Num, Ordering Order = Ordering::HIGHER,
+          typename Base = std::ratio<9, 10>>
+void exponentialRank(Population<Genome>& population) {
+    static_assert(Num >= 1, "Selector must leave at least 1 individual in the "
+                            "population");
+    static_assert(Base::num > 0 && Base::num < Base::den,
+                  "Exponential rank base must be in (0, 1)");
+    assert(population.isEvaluated());
+
+    const double base = static_cast<double>(Base::num) / Base::den;
+    auto& weights = details::scratch().weights;
+    auto& picks = details::scratch().picks;
+    details::rankWeights(population, Order, [&](std::size_t rank) {
+        return std::pow(base, static_cast<double>(rank));
+    }, weights);
+    details::universalSample(weights, Num, picks);
+    population.keep(picks);
 }
 }
 }
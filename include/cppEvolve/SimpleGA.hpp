@@ -2,9 +2,16 @@
 #define SIMPLEGA_H_
 
 #include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
+#include "cppEvolve/ParallelEvaluator.hpp"
+#include "cppEvolve/FitnessCache.hpp"
+#include "cppEvolve/Sizing.hpp"
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <vector>
 
 namespace evolve {
@@ -27,18 +34,36 @@ using EvaluatorType = std::function<double(const Genome&)>;
 template <typename Genome>
 using CrossoverType = std::function<Genome(const Genome&, const Genome&)>;
 
+/// Function which combines two parents into a child, writing it over an
+/// existing genome so that its storage is reused
+template <typename Genome>
+using CrossoverIntoType =
+    std::function<void(const Genome&, const Genome&, Genome&)>;
+
 /// Function which will alter a member of the population in some way
 template <typename Genome>
 using MutatorType = std::function<void(Genome&)>;
 
-/// Function which removes the less fit members from the population
+/// Mutator which reports the change it made (see Change)
+template <typename Genome>
+using DeltaMutatorType = std::function<Change(Genome&)>;
+
+/// Function which returns the fitness of a mutated genome given the change
+/// made to it and its fitness before the change
+template <typename Genome>
+using DeltaEvaluatorType =
+    std::function<double(const Genome&, const Change&, double)>;
+
+/// Function which removes the less fit members from the population. The
+/// population is fully evaluated when the selector is called.
 template <typename Genome>
-using SelectorType =
-    std::function<void(std::vector<Genome>&, EvaluatorType<Genome>)>;
+using SelectorType = std::function<void(Population<Genome>&)>;
 
 /*!
  * Defines a Simple genetic algorithm. That is, an algorithm for which no
  * special behavior is required to copy or modify the genome.
+ * @param PopSize The initial size of the population, which may be changed at
+ * runtime with setPopulationSize or a sizing policy
  */
 template <typename Genome, size_t PopSize = 100>
 class SimpleGA {
@@ -62,6 +87,21 @@ public:
     SimpleGA(GeneratorType<Genome> _generator, EvaluatorType<Genome> _evaluator,
              CrossoverType<Genome> _crossover, MutatorType<Genome> _mutator,
              SelectorType<Genome> _selector)
+        : generator(_generator),
+          evaluator(_evaluator),
+          crossover([_crossover](const Genome& g1, const Genome& g2,
+                                 Genome& child) { child = _crossover(g1, g2); }),
+          mutator(_mutator),
+          selector(_selector) {}
+
+    /*!
+     * As above, but '_crossover' writes the child over a genome retained from
+     * a discarded member, so that no genome is allocated once the population
+     * has reached its full size.
+     */
+    SimpleGA(GeneratorType<Genome> _generator, EvaluatorType<Genome> _evaluator,
+             CrossoverIntoType<Genome> _crossover, MutatorType<Genome> _mutator,
+             SelectorType<Genome> _selector)
         : generator(_generator),
           evaluator(_evaluator),
           crossover(_crossover),
@@ -70,67 +110,283 @@ public:
 
     virtual ~SimpleGA() {}
 
+    using GenomeType = Genome;
+
     virtual void run(unsigned int generations,
                      unsigned int logFrequency = 100) {
-        // Generation: create the new members
-        for (auto i = 0U; i < PopSize; ++i) {
+        initialize();
+
+        for (auto i = 0U; i < generations; ++i) {
+            step();
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Generation(" << i
+                          << ") - Fitness:" << bestScore << std::endl;
+            }
+        }
+        printBest(std::cout);
+    }
+
+    /*!
+     * Generation: fill the population with members from the generator
+     */
+    void initialize() {
+        bestScore = utils::worstFitness(ordering);
+        stagnation = 0;
+        generation = 0;
+        population.reserve(std::max(populationSize, capacity));
+        while (population.size() < populationSize) {
             population.push_back(generator());
         }
+    }
 
-        for (auto generation = 0U; generation < generations; ++generation) {
-            // Crossover: Add missing members
-            auto popSizePostSelection = population.size();
-            while (population.size() < PopSize) {
-                population.push_back(
-                    crossover(population[random_uint(popSizePostSelection)],
-                              population[random_uint(popSizePostSelection)]));
-            }
+    /*!
+     * Advance the evolution by a single generation
+     */
+    void step() {
+        // Crossover: Add missing members
+        auto popSizePostSelection = population.size();
+        while (population.size() < populationSize) {
+            auto& child = population.append();
+            crossover(population[random_uint(popSizePostSelection)].genome,
+                      population[random_uint(popSizePostSelection)].genome,
+                      child.genome);
+        }
 
-            // Mutation: Mutate at least rate*popsize members
-            for (size_t i = 0; i < PopSize * mutationRate; ++i) {
-                auto index = random_uint(PopSize);
-                mutator(population[index]);
+        // Mutation: Mutate at least rate*popsize members
+        for (size_t i = 0; i < population.size() * mutationRate; ++i) {
+            auto& member = population[random_uint(population.size())];
+            if (deltaMutator) {
+                auto change = deltaMutator(member.genome);
+                if (member.evaluated && change.kind != Change::NONE) {
+                    member.fitness =
+                        deltaEvaluator(member.genome, change, member.fitness);
+                }
+            } else {
+                mutator(member.genome);
+                member.invalidate();
             }
+        }
 
-            // Selection: Destroy the least fit members
-            selector(population, evaluator);
+        // Evaluation: Score the new and changed members
+        evaluate();
 
-            if (evaluator(population[0]) > bestScore) {
-                bestMember = population[0];
-                bestScore = evaluator(population[0]);
-            }
+        GenerationStats stats;
+        if (sizingPolicy) {
+            population.statistics(stats.meanFitness, stats.fitnessDeviation);
+        }
 
-            if (generation % logFrequency == 0) {
-                std::cout << "Generation(" << generation
-                          << ") - Fitness:" << bestScore << std::endl;
+        // Selection: Destroy the least fit members
+        selector(population);
+
+        auto best = population.fittest(ordering);
+        if (best != population.size() &&
+            utils::better(ordering, population[best].fitness, bestScore)) {
+            bestMember = population[best].genome;
+            bestScore = population[best].fitness;
+            stagnation = 0;
+        } else {
+            ++stagnation;
+        }
+
+        // Sizing: Choose the population size of the next generation
+        if (sizingPolicy) {
+            stats.generation = generation;
+            stats.populationSize = populationSize;
+            stats.bestScore = bestScore;
+            stats.stagnation = stagnation;
+            setPopulationSize(sizingPolicy(stats));
+        }
+        ++generation;
+    }
+
+    /*!
+     * Copies of the 'count' fittest members of the population, along with
+     * their cached fitness (used for migration between islands)
+     */
+    std::vector<Individual<Genome>> emigrants(std::size_t count) {
+        evaluate();
+        std::vector<Individual<Genome>> result;
+        for (auto index : population.ranked(ordering, count)) {
+            result.push_back(population[index]);
+        }
+        return result;
+    }
+
+    /*!
+     * Add members from another population. They fill the space left by
+     * selection if possible and otherwise replace the least fit members.
+     */
+    void immigrate(std::vector<Individual<Genome>>& migrants) {
+        evaluate();
+        auto replaced =
+            population.ranked(utils::reversed(ordering), migrants.size());
+        auto next = replaced.begin();
+
+        for (auto& migrant : migrants) {
+            if (population.size() < populationSize) {
+                population.push_back(std::move(migrant));
+            } else if (next != replaced.end()) {
+                population[*next++] = std::move(migrant);
             }
         }
-        std::cout << "Best: ";
+        migrants.clear();
+    }
+
+    /// Print the historically best member and its fitness
+    void printBest(std::ostream& out) const {
+        out << "Best: ";
         for (const auto& allele : bestMember) {
-            std::cout << allele << " ";
+            out << allele << " ";
         }
-        std::cout << std::endl << "Fitness: " << evaluator(bestMember)
-                  << std::endl;
+        out << std::endl << "Fitness: " << bestScore << std::endl;
     }
 
+    /// Get the historically best member
+    const Genome& getBest() const { return bestMember; }
+
+    /// Get the fitness of the historically best member
+    double getBestScore() const { return bestScore; }
+
+    /*!
+     * Set whether HIGHER or LOWER fitness is better. This must agree with
+     * the Ordering given to the selector.
+     */
+    void setOrdering(Ordering _ordering) { ordering = _ordering; }
+
+    Ordering getOrdering() const { return ordering; }
+
     void setMutationRate(float rate) { mutationRate = rate; }
 
-    void setPopulation(const std::array<Genome, PopSize>& _population) {
-        population = _population;
+    /*!
+     * Mutate with '_mutator' instead of the mutator given to the constructor,
+     * and update the fitness of evaluated members with '_evaluator' rather
+     * than evaluating them again. '_evaluator' must return the fitness the
+     * evaluator would give the mutated genome; for a swap in a path this
+     * only involves the edges next to the two positions.
+     */
+    void setDeltaMutator(DeltaMutatorType<Genome> _mutator,
+                         DeltaEvaluatorType<Genome> _evaluator) {
+        deltaMutator = _mutator;
+        deltaEvaluator = _evaluator;
     }
 
-    std::array<Genome, PopSize>& getPopulation() const { return population; }
+    /*!
+     * Evaluate the population on 'workers' threads (0 for one per core, 1 to
+     * evaluate serially on the calling thread). 'safety' declares whether the
+     * evaluator may be shared by the workers or must be copied per thread.
+     */
+    void setEvaluationThreads(unsigned int _workers,
+                              ThreadSafety _safety = ThreadSafety::SHARED) {
+        workers = _workers;
+        safety = _safety;
+        parallelEvaluator.reset();
+        if (workers != 1) {
+            parallelEvaluator.reset(
+                new ParallelEvaluator<Genome, EvaluatorType<Genome>>(
+                    activeEvaluator(), workers, safety));
+        }
+    }
+
+    /*!
+     * Remember the fitness of up to 'capacity' genomes, keyed by their hash
+     * (see FitnessCache), so that duplicates of earlier members are not
+     * evaluated again. A capacity of 0 disables the cache.
+     */
+    void setFitnessCache(std::size_t capacity) {
+        fitnessCache.reset();
+        if (capacity != 0) {
+            fitnessCache = std::make_shared<FitnessCache<Genome>>(capacity);
+            cachedEvaluator =
+                CachedEvaluator<Genome, EvaluatorType<Genome>>{evaluator,
+                                                               fitnessCache};
+        }
+        setEvaluationThreads(workers, safety);
+    }
+
+    /// The fitness cache with its hit counters, or null if disabled
+    const FitnessCache<Genome>* getFitnessCache() const {
+        return fitnessCache.get();
+    }
+
+    /*!
+     * Replace the population with the given members. The population size is
+     * set to the number of members.
+     */
+    void setPopulation(const std::vector<Genome>& _population) {
+        population.clear();
+        populationSize = _population.size();
+        population.reserve(std::max(populationSize, capacity));
+        for (const auto& member : _population) {
+            population.push_back(member);
+        }
+    }
+
+    /*!
+     * Set the number of members the population is refilled to each
+     * generation. Storage is only reallocated if 'size' exceeds the capacity
+     * reserved so far.
+     */
+    void setPopulationSize(std::size_t size) {
+        assert(size > 0);
+        populationSize = size;
+        capacity = std::max(capacity, size);
+        population.reserve(capacity);
+    }
+
+    std::size_t getPopulationSize() const { return populationSize; }
+
+    /*!
+     * Let 'policy' choose the population size after every generation (see
+     * cppEvolve/Sizing.hpp). Storage for 'maxSize' members is reserved up
+     * front so that resizing never reallocates during the run.
+     */
+    void setSizingPolicy(SizingPolicy policy, std::size_t maxSize) {
+        sizingPolicy = policy;
+        capacity = std::max(capacity, maxSize);
+        population.reserve(capacity);
+    }
+
+    const Population<Genome>& getPopulation() const { return population; }
 
 protected:
-    std::vector<Genome> population;
+    const EvaluatorType<Genome>& activeEvaluator() const {
+        return fitnessCache ? cachedEvaluator : evaluator;
+    }
+
+    void evaluate() {
+        if (parallelEvaluator) {
+            parallelEvaluator->evaluate(population);
+        } else {
+            population.evaluate(activeEvaluator());
+        }
+    }
+
+    Population<Genome> population;
     GeneratorType<Genome> generator;
     EvaluatorType<Genome> evaluator;
-    CrossoverType<Genome> crossover;
+    CrossoverIntoType<Genome> crossover;
     MutatorType<Genome> mutator;
+    DeltaMutatorType<Genome> deltaMutator;
+    DeltaEvaluatorType<Genome> deltaEvaluator;
     SelectorType<Genome> selector;
+    std::unique_ptr<ParallelEvaluator<Genome, EvaluatorType<Genome>>>
+        parallelEvaluator;
+    unsigned int workers = 1;
+    ThreadSafety safety = ThreadSafety::SHARED;
+
+    std::shared_ptr<FitnessCache<Genome>> fitnessCache;
+    EvaluatorType<Genome> cachedEvaluator;
 
     Genome bestMember;
     double bestScore = std::numeric_limits<float>::lowest();
+    Ordering ordering = Ordering::HIGHER;
+
+    std::size_t populationSize = PopSize;
+    std::size_t capacity = PopSize;
+    SizingPolicy sizingPolicy;
+    unsigned int stagnation = 0;
+    unsigned int generation = 0;
     float mutationRate = 0.6f;
 };
 }
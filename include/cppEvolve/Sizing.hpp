@@ -0,0 +1,115 @@
+#ifndef SIZING_H_
+#define SIZING_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+
+namespace evolve {
+
+/*!
+ * A summary of the population after evaluation, given to sizing policies.
+ */
+struct GenerationStats {
+    /// Number of generations completed before this one
+    unsigned int generation;
+
+    /// The current target population size
+    std::size_t populationSize;
+
+    /// Fitness of the historically best member
+    double bestScore;
+
+    /// Mean and standard deviation of the fitness of the evaluated population
+    double meanFitness;
+    double fitnessDeviation;
+
+    /// Generations since the best score last improved
+    unsigned int stagnation;
+};
+
+/// Function which returns the population size to use for the next generation
+using SizingPolicy = std::function<std::size_t(const GenerationStats&)>;
+
+/*!
+ * Built-in population sizing policies.
+ */
+namespace sizing {
+
+/*!
+ * Multiplies the population size by 'factor' whenever the best score has not
+ * improved for 'patience' generations, and divides it by 'factor' (down to
+ * 'minSize') in generations where the best score improves.
+ */
+class Stagnation {
+public:
+    Stagnation(std::size_t _minSize, std::size_t _maxSize,
+               unsigned int _patience = 10, double _factor = 1.5)
+        : minSize(_minSize), maxSize(_maxSize), patience(_patience),
+          factor(_factor) {
+        assert(patience > 0);
+    }
+
+    std::size_t operator()(const GenerationStats& stats) const {
+        auto size = static_cast<double>(stats.populationSize);
+        if (stats.stagnation == 0) {
+            size /= factor;
+        } else if (stats.stagnation % patience == 0) {
+            size *= factor;
+        }
+        return clamp(size);
+    }
+
+    std::size_t getMaxSize() const { return maxSize; }
+
+private:
+    std::size_t clamp(double size) const {
+        return std::min(maxSize,
+                        std::max(minSize, static_cast<std::size_t>(size)));
+    }
+
+    std::size_t minSize, maxSize;
+    unsigned int patience;
+    double factor;
+};
+
+/*!
+ * Grows the population by 'factor' while its diversity (the coefficient of
+ * variation of the fitness) is below 'low', and shrinks it by 'factor' while
+ * the diversity is above 'high'.
+ */
+class Diversity {
+public:
+    Diversity(std::size_t _minSize, std::size_t _maxSize, double _low = 0.01,
+              double _high = 0.1, double _factor = 1.25)
+        : minSize(_minSize), maxSize(_maxSize), low(_low), high(_high),
+          factor(_factor) {}
+
+    std::size_t operator()(const GenerationStats& stats) const {
+        auto size = static_cast<double>(stats.populationSize);
+        auto scale = std::abs(stats.meanFitness);
+        auto diversity =
+            stats.fitnessDeviation / (scale > 0 ? scale : 1.0);
+
+        if (diversity < low) {
+            size *= factor;
+        } else if (diversity > high) {
+            size /= factor;
+        }
+        return std::min(maxSize,
+                        std::max(minSize, static_cast<std::size_t>(size)));
+    }
+
+    std::size_t getMaxSize() const { return maxSize; }
+
+private:
+    std::size_t minSize, maxSize;
+    double low, high;
+    double factor;
+};
+}
+}
+
+#endif
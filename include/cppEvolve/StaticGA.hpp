@@ -0,0 +1,204 @@
+#ifndef STATICGA_H_
+#define STATICGA_H_
+
+#include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <utility>
+
+namespace evolve {
+
+/*!
+ * Wraps the function 'f' in a type of its own, so that a StaticGA given it
+ * calls 'f' directly rather than through a function pointer. Use
+ * EVOLVE_FUNCTION to name the type.
+ */
+template <typename F, F f>
+struct StaticFunction {
+    template <typename... Args>
+    auto operator()(Args&&... args) const
+        -> decltype(f(std::forward<Args>(args)...)) {
+        return f(std::forward<Args>(args)...);
+    }
+};
+
+/// A StaticFunction calling 'f', e.g.
+/// EVOLVE_FUNCTION(list1d::mutator::swap<Genome>)
+#define EVOLVE_FUNCTION(...)                                                   \
+    ::evolve::StaticFunction<decltype(&__VA_ARGS__), &__VA_ARGS__> {}
+
+namespace details {
+
+// Crossovers may either write the child into their third argument or return
+// it; the first form is preferred
+template <typename Crossover, typename Genome>
+auto crossInto(const Crossover& crossover, const Genome& g1, const Genome& g2,
+               Genome& child, int) -> decltype(crossover(g1, g2, child)) {
+    crossover(g1, g2, child);
+}
+
+template <typename Crossover, typename Genome>
+void crossInto(const Crossover& crossover, const Genome& g1, const Genome& g2,
+               Genome& child, long) {
+    child = crossover(g1, g2);
+}
+}
+
+/*!
+ * A genetic algorithm with the same generation as SimpleGA, but with its
+ * operators given as template arguments rather than held in std::function.
+ * Lambdas, function objects and StaticFunctions are then called directly, so
+ * the compiler may inline them into the generation loop. This matters most
+ * when the evaluator and operators are cheap. A plain function pointer is
+ * still called indirectly; wrap it with EVOLVE_FUNCTION.
+ *
+ * Use makeStaticGA to deduce the operator types. StaticGA has none of the
+ * run time options of SimpleGA (threads, fitness cache, delta mutators,
+ * sizing policies).
+ *
+ * The crossover may have either the CrossoverType or the CrossoverIntoType
+ * signature.
+ */
+template <typename Genome, typename Generator, typename Evaluator,
+          typename Crossover, typename Mutator, typename Selector>
+class StaticGA {
+public:
+    /*!
+     * @param _populationSize The number of members the population is refilled
+     * to each generation
+     */
+    StaticGA(std::size_t _populationSize, Generator _generator,
+             Evaluator _evaluator, Crossover _crossover, Mutator _mutator,
+             Selector _selector)
+        : generator(std::move(_generator)),
+          evaluator(std::move(_evaluator)),
+          crossover(std::move(_crossover)),
+          mutator(std::move(_mutator)),
+          selector(std::move(_selector)),
+          populationSize(_populationSize) {
+        assert(populationSize > 0);
+    }
+
+    using GenomeType = Genome;
+
+    void run(unsigned int generations, unsigned int logFrequency = 100) {
+        initialize();
+
+        for (auto i = 0U; i < generations; ++i) {
+            step();
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Generation(" << i
+                          << ") - Fitness:" << bestScore << std::endl;
+            }
+        }
+        printBest(std::cout);
+    }
+
+    /// Fill the population with members from the generator
+    void initialize() {
+        bestScore = utils::worstFitness(ordering);
+        population.reserve(populationSize);
+        while (population.size() < populationSize) {
+            population.push_back(generator());
+        }
+    }
+
+    /// Advance the evolution by a single generation
+    void step() {
+        // The engine is looked up once rather than per random number
+        auto& random = utils::engine();
+        const auto parents = population.size();
+        while (population.size() < populationSize) {
+            auto& child = population.append();
+            const auto& g1 = population[utils::bounded(random, parents)];
+            const auto& g2 = population[utils::bounded(random, parents)];
+            details::crossInto(crossover, g1.genome, g2.genome, child.genome,
+                               0);
+        }
+
+        const auto mutations = population.size() * mutationRate;
+        for (std::size_t i = 0; i < mutations; ++i) {
+            auto& member =
+                population[utils::bounded(random, population.size())];
+            mutator(member.genome);
+            member.invalidate();
+        }
+
+        population.evaluate(evaluator);
+        selector(population);
+
+        auto best = population.fittest(ordering);
+        if (best != population.size() &&
+            utils::better(ordering, population[best].fitness, bestScore)) {
+            bestMember = population[best].genome;
+            bestScore = population[best].fitness;
+        }
+    }
+
+    /// Print the historically best member and its fitness
+    void printBest(std::ostream& out) const {
+        out << "Best: ";
+        for (const auto& allele : bestMember) {
+            out << allele << " ";
+        }
+        out << std::endl << "Fitness: " << bestScore << std::endl;
+    }
+
+    /// Get the historically best member
+    const Genome& getBest() const { return bestMember; }
+
+    /// Get the fitness of the historically best member
+    double getBestScore() const { return bestScore; }
+
+    /// Set whether HIGHER or LOWER fitness is better. This must agree with
+    /// the Ordering given to the selector.
+    void setOrdering(Ordering _ordering) { ordering = _ordering; }
+
+    Ordering getOrdering() const { return ordering; }
+
+    void setMutationRate(float rate) { mutationRate = rate; }
+
+    const Population<Genome>& getPopulation() const { return population; }
+
+private:
+    Population<Genome> population;
+    Generator generator;
+    Evaluator evaluator;
+    Crossover crossover;
+    Mutator mutator;
+    Selector selector;
+
+    Genome bestMember{};
+    double bestScore = utils::worstFitness(Ordering::HIGHER);
+    Ordering ordering = Ordering::HIGHER;
+
+    std::size_t populationSize;
+    float mutationRate = 0.6f;
+};
+
+/*!
+ * Construct a StaticGA with 'PopSize' members, deducing the types of the
+ * operators, e.g.
+ *
+ *     auto ga = makeStaticGA<Genome, 50>(generator, [](const Genome& g) {...},
+ *         EVOLVE_FUNCTION(list1d::crossover::randomCopyInto<Genome>),
+ *         EVOLVE_FUNCTION(list1d::mutator::swap<Genome>),
+ *         selector::top<Genome, 5, Ordering::LOWER>);
+ */
+template <typename Genome, std::size_t PopSize = 100, typename Generator,
+          typename Evaluator, typename Crossover, typename Mutator,
+          typename Selector>
+StaticGA<Genome, Generator, Evaluator, Crossover, Mutator, Selector>
+makeStaticGA(Generator generator, Evaluator evaluator, Crossover crossover,
+             Mutator mutator, Selector selector) {
+    return StaticGA<Genome, Generator, Evaluator, Crossover, Mutator,
+                    Selector>(PopSize, std::move(generator),
+                              std::move(evaluator), std::move(crossover),
+                              std::move(mutator), std::move(selector));
+}
+}
+
+#endif
@@ -0,0 +1,445 @@
+#ifndef STEADYSTATEGA_H_
+#define STEADYSTATEGA_H_
+
+#include "cppEvolve/utils.hpp"
+#include "cppEvolve/Population.hpp"
+#include "cppEvolve/ParallelEvaluator.hpp"
+#include "cppEvolve/AsyncEvaluator.hpp"
+#include "cppEvolve/SimpleGA.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace evolve {
+
+/// How SteadyStateGA chooses the member a child replaces
+enum class Replacement {
+    /// The least fit member of the population
+    WORST,
+
+    /// The least fit of a few members drawn at random (see
+    /// SteadyStateGA::setReplacement)
+    TOURNAMENT
+};
+
+namespace details {
+
+/*!
+ * A binary heap of the indices of a population's members with the least fit
+ * on top. The position of each member in the heap is recorded, so that the
+ * member whose fitness changed can be moved to its new place in O(log N).
+ */
+template <typename Genome>
+class WorstHeap {
+public:
+    void build(const Population<Genome>& population, Ordering _ordering) {
+        ordering = _ordering;
+        heap.resize(population.size());
+        slots.resize(population.size());
+        for (std::size_t i = 0; i < heap.size(); ++i) {
+            heap[i] = slots[i] = i;
+        }
+        for (auto i = heap.size() / 2; i-- > 0;) {
+            siftDown(population, i);
+        }
+    }
+
+    /// The index of the least fit member
+    std::size_t top() const { return heap[0]; }
+
+    /// Restore the heap after the fitness of 'member' changed
+    void update(const Population<Genome>& population, std::size_t member) {
+        siftDown(population, siftUp(population, slots[member]));
+    }
+
+private:
+    bool worse(const Population<Genome>& population, std::size_t a,
+               std::size_t b) const {
+        return utils::better(ordering, population[heap[b]].fitness,
+                             population[heap[a]].fitness);
+    }
+
+    void place(std::size_t slot, std::size_t member) {
+        heap[slot] = member;
+        slots[member] = slot;
+    }
+
+    void exchange(std::size_t a, std::size_t b) {
+        const auto member = heap[a];
+        place(a, heap[b]);
+        place(b, member);
+    }
+
+    std::size_t siftUp(const Population<Genome>& population,
+                       std::size_t slot) {
+        while (slot > 0 && worse(population, slot, (slot - 1) / 2)) {
+            exchange(slot, (slot - 1) / 2);
+            slot = (slot - 1) / 2;
+        }
+        return slot;
+    }
+
+    void siftDown(const Population<Genome>& population, std::size_t slot) {
+        for (;;) {
+            auto worst = slot;
+            for (auto child : {2 * slot + 1, 2 * slot + 2}) {
+                if (child < heap.size() && worse(population, child, worst))
+                    worst = child;
+            }
+            if (worst == slot)
+                return;
+            exchange(slot, worst);
+            slot = worst;
+        }
+    }
+
+    std::vector<std::size_t> heap;  // member indices, least fit first
+    std::vector<std::size_t> slots; // the position of each member in 'heap'
+    Ordering ordering = Ordering::HIGHER;
+};
+}
+
+/*!
+ * A steady state genetic algorithm. Rather than replacing the population
+ * each generation, every step breeds a few children from parents chosen by
+ * tournament, evaluates them and lets each replace a member chosen by the
+ * Replacement policy, unless that member is fitter than the child. The
+ * population is kept in a heap ordered by fitness, so the least fit member
+ * is found and the population reordered in O(log N) per child. There is no
+ * sorting or selection pass over the whole population.
+ *
+ * This suits expensive evaluators: only the new children are evaluated each
+ * step, and a good child can be chosen as a parent by the very next step.
+ * Where evaluations take widely varying times, runAsync keeps breeding
+ * while they are in flight rather than waiting for each step's slowest.
+ *
+ * @param PopSize The size of the population
+ */
+template <typename Genome, std::size_t PopSize = 100>
+class SteadyStateGA {
+public:
+    /*!
+     * @param _generator A function which will return instances of Genome to be
+     * used in the initial population
+     *
+     * @param _evaluator A function which returns a double representing the
+     * fitness of a member of the population
+     *
+     * @param _crossover A function which returns a new member of the population
+     * by combining two parents
+     *
+     * @param _mutator A function which will alter a member of the population in
+     * some way
+     */
+    SteadyStateGA(GeneratorType<Genome> _generator,
+                  EvaluatorType<Genome> _evaluator,
+                  CrossoverType<Genome> _crossover,
+                  MutatorType<Genome> _mutator)
+        : generator(_generator),
+          evaluator(_evaluator),
+          crossover([_crossover](const Genome& g1, const Genome& g2,
+                                 Genome& child) { child = _crossover(g1, g2); }),
+          mutator(_mutator) {}
+
+    /// As above, but '_crossover' writes the child over the genome of a
+    /// replaced member
+    SteadyStateGA(GeneratorType<Genome> _generator,
+                  EvaluatorType<Genome> _evaluator,
+                  CrossoverIntoType<Genome> _crossover,
+                  MutatorType<Genome> _mutator)
+        : generator(_generator),
+          evaluator(_evaluator),
+          crossover(_crossover),
+          mutator(_mutator) {}
+
+    virtual ~SteadyStateGA() {}
+
+    using GenomeType = Genome;
+
+    /// Run 'steps' steps, logging every 'logFrequency' steps
+    virtual void run(unsigned int steps, unsigned int logFrequency = 1000) {
+        initialize();
+
+        for (auto i = 0U; i < steps; ++i) {
+            step();
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Step(" << i << ") - Fitness:" << bestScore
+                          << std::endl;
+            }
+        }
+        printBest(std::cout);
+    }
+
+    /*!
+     * Evaluate 'children' children on the threads set by
+     * setAsyncEvaluation, logging every 'logFrequency' evaluations. Children
+     * are bred ahead to keep the work queue full, and each is inserted as
+     * soon as its evaluation finishes, whatever the order they were bred in.
+     * The initial population is evaluated the same way.
+     */
+    virtual void runAsync(unsigned int children,
+                          unsigned int logFrequency = 1000) {
+        AsyncEvaluator<Genome, EvaluatorType<Genome>> async(
+            evaluator, asyncWorkers, asyncCapacity, asyncSafety);
+
+        bestScore = utils::worstFitness(ordering);
+        evaluations = 0;
+        population.clear();
+        population.reserve(PopSize);
+        for (std::size_t i = 0; i < PopSize; ++i) {
+            async.submit(generator());
+        }
+        for (std::size_t i = 0; i < PopSize; ++i) {
+            auto result = async.collect();
+            auto& member = population.append();
+            member.genome = std::move(result.genome);
+            member.fitness = result.fitness;
+            member.evaluated = true;
+            track(member);
+        }
+        evaluations += PopSize;
+        heap.build(population, ordering);
+
+        // Enough children to keep every worker busy with the queue full
+        const std::size_t ahead = async.getCapacity() + async.getWorkers();
+        Individual<Genome> child;
+        unsigned int bred = 0;
+        for (; bred < children && bred < ahead; ++bred) {
+            breed(child.genome);
+            async.submit(std::move(child.genome));
+        }
+
+        for (auto i = 0U; async.getPending() > 0; ++i) {
+            auto result = async.collect();
+            ++evaluations;
+            child.genome = std::move(result.genome);
+            child.fitness = result.fitness;
+            child.evaluated = true;
+            insert(child);
+
+            // The child now holds the replaced genome; breed over it
+            if (bred < children) {
+                breed(child.genome);
+                async.submit(std::move(child.genome));
+                ++bred;
+            }
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Evaluation(" << i << ") - Fitness:" << bestScore
+                          << std::endl;
+            }
+        }
+        printBest(std::cout);
+    }
+
+    /// Fill the population with members from the generator and evaluate it
+    void initialize() {
+        bestScore = utils::worstFitness(ordering);
+        evaluations = 0;
+        population.clear();
+        population.reserve(PopSize);
+        while (population.size() < PopSize) {
+            population.push_back(generator());
+        }
+        evaluations += evaluate(population);
+        heap.build(population, ordering);
+        for (const auto& member : population) {
+            track(member);
+        }
+    }
+
+    /// Breed, evaluate and insert 'offspring' children
+    void step() {
+        brood.clear();
+        for (std::size_t i = 0; i < offspring; ++i) {
+            breed(brood.append().genome);
+        }
+        evaluations += evaluate(brood);
+
+        for (auto& child : brood) {
+            insert(child);
+        }
+    }
+
+    /*!
+     * Let 'child', which must have been evaluated, replace the member chosen
+     * by the replacement policy, unless that member is fitter. Returns true
+     * if the child was inserted. The child is left holding the genome it
+     * replaced.
+     */
+    bool insert(Individual<Genome>& child) {
+        assert(child.evaluated);
+        const auto victim = (replacement == Replacement::WORST)
+                                ? heap.top()
+                                : inverseTournament();
+        auto& member = population[victim];
+        if (utils::better(ordering, member.fitness, child.fitness))
+            return false;
+
+        using std::swap;
+        swap(member.genome, child.genome);
+        member.fitness = child.fitness;
+        member.evaluated = true;
+        heap.update(population, victim);
+        track(member);
+        return true;
+    }
+
+    /// Print the historically best member and its fitness
+    void printBest(std::ostream& out) const {
+        out << "Best: ";
+        for (const auto& allele : bestMember) {
+            out << allele << " ";
+        }
+        out << std::endl << "Fitness: " << bestScore << std::endl;
+    }
+
+    /// Get the historically best member
+    const Genome& getBest() const { return bestMember; }
+
+    /// Get the fitness of the historically best member
+    double getBestScore() const { return bestScore; }
+
+    /// The number of evaluations since initialize
+    std::size_t getEvaluations() const { return evaluations; }
+
+    /// Set whether HIGHER or LOWER fitness is better
+    void setOrdering(Ordering _ordering) { ordering = _ordering; }
+
+    Ordering getOrdering() const { return ordering; }
+
+    /// Set the probability that a child is mutated
+    void setMutationRate(float rate) { mutationRate = rate; }
+
+    /// Set the number of children bred and evaluated together in each step
+    void setOffspring(std::size_t count) {
+        assert(count > 0);
+        offspring = count;
+    }
+
+    /// Set the number of members drawn for each parent's tournament
+    void setTournamentSize(std::size_t size) {
+        assert(size > 0);
+        tournamentSize = size;
+    }
+
+    /*!
+     * Set how the member a child replaces is chosen. With
+     * Replacement::TOURNAMENT it is the least fit of 'size' members drawn
+     * at random, which is less greedy than always replacing the least fit.
+     */
+    void setReplacement(Replacement _replacement, std::size_t size = 2) {
+        assert(size > 0);
+        replacement = _replacement;
+        replacementSize = size;
+    }
+
+    /*!
+     * Evaluate the children of each step on 'workers' threads (0 for one per
+     * core, 1 to evaluate serially). Only useful if each step breeds several
+     * children; see setOffspring.
+     */
+    void setEvaluationThreads(unsigned int workers,
+                              ThreadSafety safety = ThreadSafety::SHARED) {
+        parallelEvaluator.reset();
+        if (workers != 1) {
+            parallelEvaluator.reset(
+                new ParallelEvaluator<Genome, EvaluatorType<Genome>>(
+                    evaluator, workers, safety));
+        }
+    }
+
+    /*!
+     * Set the threads used by runAsync: 'workers' evaluate children (0 for
+     * one per core) and at most 'capacity' children wait for them (0 for one
+     * per worker). As the evaluations overlap, use at least as many workers
+     * as there are cores whenever the evaluator waits on something else.
+     */
+    void setAsyncEvaluation(unsigned int workers, std::size_t capacity = 0,
+                            ThreadSafety safety = ThreadSafety::SHARED) {
+        asyncWorkers = workers;
+        asyncCapacity = capacity;
+        asyncSafety = safety;
+    }
+
+    const Population<Genome>& getPopulation() const { return population; }
+
+protected:
+    std::size_t evaluate(Population<Genome>& members) {
+        return parallelEvaluator ? parallelEvaluator->evaluate(members)
+                                 : members.evaluate(evaluator);
+    }
+
+    // Write a child of two tournament winners over 'child'
+    void breed(Genome& child) {
+        crossover(population[tournament()].genome,
+                  population[tournament()].genome, child);
+        if (utils::random_real() < mutationRate) {
+            mutator(child);
+        }
+    }
+
+    // Record 'member' if it is the fittest seen
+    void track(const Individual<Genome>& member) {
+        if (utils::better(ordering, member.fitness, bestScore)) {
+            bestMember = member.genome;
+            bestScore = member.fitness;
+        }
+    }
+
+    std::size_t tournament() const {
+        auto winner = utils::random_uint(population.size());
+        for (std::size_t i = 1; i < tournamentSize; ++i) {
+            const auto entrant = utils::random_uint(population.size());
+            if (utils::better(ordering, population[entrant].fitness,
+                              population[winner].fitness))
+                winner = entrant;
+        }
+        return winner;
+    }
+
+    std::size_t inverseTournament() const {
+        auto loser = utils::random_uint(population.size());
+        for (std::size_t i = 1; i < replacementSize; ++i) {
+            const auto entrant = utils::random_uint(population.size());
+            if (utils::better(ordering, population[loser].fitness,
+                              population[entrant].fitness))
+                loser = entrant;
+        }
+        return loser;
+    }
+
+    Population<Genome> population;
+    Population<Genome> brood; // the children of the current step
+    details::WorstHeap<Genome> heap;
+
+    GeneratorType<Genome> generator;
+    EvaluatorType<Genome> evaluator;
+    CrossoverIntoType<Genome> crossover;
+    MutatorType<Genome> mutator;
+    std::unique_ptr<ParallelEvaluator<Genome, EvaluatorType<Genome>>>
+        parallelEvaluator;
+
+    Genome bestMember{};
+    double bestScore = std::numeric_limits<double>::lowest();
+    Ordering ordering = Ordering::HIGHER;
+
+    std::size_t offspring = 1;
+    std::size_t tournamentSize = 2;
+    Replacement replacement = Replacement::WORST;
+    std::size_t replacementSize = 2;
+    std::size_t evaluations = 0;
+    float mutationRate = 0.6f;
+
+    unsigned int asyncWorkers = 0;
+    std::size_t asyncCapacity = 0;
+    ThreadSafety asyncSafety = ThreadSafety::SHARED;
+};
+}
+
+#endif
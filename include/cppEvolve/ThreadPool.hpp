@@ -0,0 +1,135 @@
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace evolve {
+namespace utils {
+
+/*!
+ * A fixed set of worker threads used to run data-parallel loops. The calling
+ * thread takes part in every loop as worker 0, so a pool of size 1 spawns no
+ * threads at all.
+ */
+class ThreadPool {
+public:
+    /// Construct a pool with 'workers' workers (0 uses one per hardware thread)
+    explicit ThreadPool(unsigned int workers = 0) {
+        if (workers == 0) {
+            workers = std::max(1U, std::thread::hardware_concurrency());
+        }
+        for (auto id = 1U; id < workers; ++id) {
+            threads.emplace_back([this, id]() { workerLoop(id); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    /// The number of workers, including the calling thread
+    unsigned int size() const { return threads.size() + 1; }
+
+    /*!
+     * Call task(worker, i) for every i in [0, count), distributing indices
+     * dynamically between the workers. Blocks until every call has returned.
+     * If a task throws, the first exception is rethrown here once all workers
+     * have stopped.
+     */
+    template <typename Task>
+    void parallelFor(std::size_t count, const Task& task) {
+        std::lock_guard<std::mutex> serial(loopMutex);
+
+        std::atomic<std::size_t> next{0};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+
+        std::function<void(unsigned int)> body = [&](unsigned int worker) {
+            for (auto i = next++; i < count; i = next++) {
+                try {
+                    task(worker, i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = count; // abandon the remaining work
+                }
+            }
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &body;
+            pending = threads.size();
+            ++round;
+        }
+        wake.notify_all();
+
+        body(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return pending == 0; });
+        job = nullptr;
+        lock.unlock();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    void workerLoop(unsigned int id) {
+        unsigned long seen = 0;
+        for (;;) {
+            std::function<void(unsigned int)>* current;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock,
+                          [this, seen]() { return stopping || round != seen; });
+                if (stopping)
+                    return;
+                seen = round;
+                current = job;
+            }
+
+            (*current)(id);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --pending;
+            }
+            finished.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::mutex loopMutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    std::function<void(unsigned int)>* job = nullptr;
+    std::size_t pending = 0;
+    unsigned long round = 0;
+    bool stopping = false;
+};
+}
+}
+
+#endif
@@ -4,19 +4,33 @@
 #include "cppEvolve/Genome/Tree/Tree.hpp"
 #include "cppEvolve/Genome/Tree/Crossover.hpp"
 #include "cppEvolve/Genome/Tree/Mutator.hpp"
+#include "cppEvolve/Genome/Tree/Simplify.hpp"
+#include "cppEvolve/Population.hpp"
+#include "cppEvolve/ParallelEvaluator.hpp"
+#include "cppEvolve/FitnessCache.hpp"
+#include "cppEvolve/Sizing.hpp"
 
-#include <limits.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
 
 namespace evolve {
 
 /*!
  * Defines a GA to use with Tree-like genomes (typically for growing algorithms.
  * @param rType The type to be returned from the functions composing the tree
- * @param PopSize The static size of the population
+ * @param PopSize The initial size of the population, which may be changed at
+ * runtime with setPopulationSize or a sizing policy
+ * @param Genome The tree representation: tree::Tree<Rtype>* or the
+ * contiguous tree::FlatTree<Rtype>
  */
-template <typename Rtype, size_t PopSize = 100>
+template <typename Rtype, size_t PopSize = 100,
+          typename Genome = tree::Tree<Rtype>*>
 class TreeGA {
 public:
+    /// Crossover writing its child over an existing (possibly null) tree
+    using CrossoverInto = function<void(const Genome&, const Genome&, Genome&)>;
+
     /*!
      * @param _generator A function which will return instances of Genome to be
      * used in the initial population
@@ -35,16 +49,39 @@ public:
      */
     TreeGA(tree::TreeFactory<Rtype> _generator,
 
-           function<float(const tree::Tree<Rtype>*)> _evaluator,
+           function<float(const Genome&)> _evaluator,
 
-           function<tree::Tree<Rtype>*(const tree::Tree<Rtype>*,
-                                       const tree::Tree<Rtype>*)> _crossover,
+           function<Genome(const Genome&, const Genome&)> _crossover,
 
-           function<void(tree::Tree<Rtype>*, const tree::TreeFactory<Rtype>&)>
-               _mutator,
+           function<void(Genome&, const tree::TreeFactory<Rtype>&)> _mutator,
 
-           function<void(std::vector<tree::Tree<Rtype>*>&,
-                         function<double(const tree::Tree<Rtype>*)>)> _selector)
+           function<void(Population<Genome>&)> _selector)
+        :
+
+          generator(_generator),
+          evaluator(_evaluator),
+          crossover([_crossover](const Genome& left, const Genome& right,
+                                 Genome& child) {
+              utils::release(child);
+              child = _crossover(left, right);
+          }),
+          mutator(_mutator),
+          selector(_selector) {}
+
+    /*!
+     * As above, but '_crossover' writes the child into a tree retained from a
+     * discarded member (e.g. tree::crossover::singlePointInto), reusing its
+     * nodes instead of allocating new ones.
+     */
+    TreeGA(tree::TreeFactory<Rtype> _generator,
+
+           function<float(const Genome&)> _evaluator,
+
+           CrossoverInto _crossover,
+
+           function<void(Genome&, const tree::TreeFactory<Rtype>&)> _mutator,
+
+           function<void(Population<Genome>&)> _selector)
         :
 
           generator(_generator),
@@ -53,91 +90,326 @@ public:
           mutator(_mutator),
           selector(_selector) {}
 
-    virtual ~TreeGA() {}
+    virtual ~TreeGA() { utils::release(bestIndividual); }
+
+    using GenomeType = Genome;
 
     /*!
      * Preform the evolution printing statistics a logFrequency intervals
      */
     virtual void run(unsigned int generations,
                      unsigned int logFrequency = 100) {
-        for (auto i = 0U; i < PopSize; ++i) {
-            population.push_back(generator.make());
+        initialize();
+
+        for (auto i = 0U; i < generations; ++i) {
+            step();
+
+            if (logFrequency != 0 && i % logFrequency == 0) {
+                std::cout << "Generation(" << i
+                          << ") - Fitness:" << bestScore << std::endl;
+            }
         }
+        printBest(std::cout);
+    }
 
-        for (auto generation = 0U; generation < generations; ++generation) {
-            selector(population, evaluator);
+    /*!
+     * Fill the population with random trees from the factory
+     */
+    void initialize() {
+        bestScore = utils::worstFitness(ordering);
+        stagnation = 0;
+        generation = 0;
+        population.reserve(std::max(populationSize, capacity));
+        while (population.size() < populationSize) {
+            population.push_back(make(static_cast<Genome*>(nullptr)));
+        }
+    }
 
-            auto popSizePostSelection = population.size();
+    /*!
+     * Advance the evolution by a single generation
+     */
+    void step() {
+        evaluate();
 
-            while (population.size() < PopSize) {
-                population.push_back(
-                    crossover(population[random_uint(popSizePostSelection)],
-                              population[random_uint(popSizePostSelection)]));
-            }
+        GenerationStats stats;
+        if (sizingPolicy) {
+            population.statistics(stats.meanFitness, stats.fitnessDeviation);
+        }
 
-            for (size_t i = 0; i < PopSize * mutationRate; ++i) {
-                auto index = random_uint(PopSize);
-                mutator(population[index], generator);
-            }
+        selector(population);
 
-            auto score = evaluator(population[0]);
-            if (score > bestScore) {
-                delete bestIndividual;
-                bestIndividual = population[0]->clone();
-                bestScore = score;
-            }
+        auto best = population.fittest(ordering);
+        if (best != population.size() &&
+            utils::better(ordering, population[best].fitness, bestScore)) {
+            utils::copyInto(bestIndividual, population[best].genome);
+            hasBest = true;
+            bestScore = population[best].fitness;
+            stagnation = 0;
+        } else {
+            ++stagnation;
+        }
 
-            if (generation % logFrequency == 0) {
-                std::cout << "Generation(" << generation
-                          << ") - Fitness:" << bestScore << std::endl;
+        if (sizingPolicy) {
+            stats.generation = generation;
+            stats.populationSize = populationSize;
+            stats.bestScore = bestScore;
+            stats.stagnation = stagnation;
+            setPopulationSize(sizingPolicy(stats));
+        }
+        ++generation;
+
+        auto popSizePostSelection = population.size();
+
+        while (population.size() < populationSize) {
+            auto& child = population.append();
+            crossover(population[random_uint(popSizePostSelection)].genome,
+                      population[random_uint(popSizePostSelection)].genome,
+                      child.genome);
+        }
+
+        for (size_t i = 0; i < population.size() * mutationRate; ++i) {
+            auto index = random_uint(population.size());
+            mutator(population[index].genome, generator);
+            population[index].invalidate();
+        }
+    }
+
+    /*!
+     * Clones of the 'count' fittest trees in the population, along with their
+     * cached fitness (used for migration between islands)
+     */
+    std::vector<Individual<Genome>> emigrants(std::size_t count) {
+        evaluate();
+        std::vector<Individual<Genome>> result;
+        for (auto index : population.ranked(ordering, count)) {
+            result.emplace_back(copyOf(population[index].genome));
+            result.back().fitness = population[index].fitness;
+            result.back().evaluated = population[index].evaluated;
+        }
+        return result;
+    }
+
+    /*!
+     * Take ownership of trees from another population, replacing the least
+     * fit members.
+     */
+    void immigrate(std::vector<Individual<Genome>>& migrants) {
+        evaluate();
+        auto replaced =
+            population.ranked(utils::reversed(ordering), migrants.size());
+        auto next = replaced.begin();
+
+        for (auto& migrant : migrants) {
+            if (population.size() < populationSize) {
+                population.push_back(std::move(migrant));
+            } else if (next != replaced.end()) {
+                population.recycle(std::move(population[*next].genome));
+                population[*next++] = std::move(migrant);
+            } else {
+                utils::release(migrant.genome);
             }
         }
-        std::cout << "Best: " << *bestIndividual << std::endl;
-        std::cout << "Fitness: " << bestScore << std::endl;
+        migrants.clear();
+    }
+
+    /// Print the historically best individual and its fitness
+    void printBest(std::ostream& out) const {
+        if (hasBest) {
+            out << "Best: " << print(bestIndividual) << std::endl;
+        }
+        out << "Fitness: " << bestScore << std::endl;
+    }
+
+    /// Get the fitness of the historically best individual
+    double getBestScore() const { return bestScore; }
+
+    /*!
+     * Set whether HIGHER or LOWER fitness is better. This must agree with
+     * the Ordering given to the selector.
+     */
+    void setOrdering(Ordering _ordering) { ordering = _ordering; }
+
+    Ordering getOrdering() const { return ordering; }
+
+    /*!
+     * Set the GA population to pre-created population. The GA takes ownership
+     * of the trees and the population size is set to their number.
+     */
+    void setPopulation(const std::vector<Genome>& _population) {
+        population.clear();
+        populationSize = _population.size();
+        population.reserve(std::max(populationSize, capacity));
+        for (auto member : _population) {
+            population.push_back(member);
+        }
     }
 
     /*!
-     * Set the GA population to pre-created population.
+     * Set the number of trees the population is refilled to each generation.
+     * Storage is only reallocated if 'size' exceeds the capacity reserved so
+     * far.
+     */
+    void setPopulationSize(std::size_t size) {
+        assert(size > 0);
+        populationSize = size;
+        capacity = std::max(capacity, size);
+        population.reserve(capacity);
+    }
+
+    std::size_t getPopulationSize() const { return populationSize; }
+
+    /*!
+     * Let 'policy' choose the population size after every generation (see
+     * cppEvolve/Sizing.hpp). Storage for 'maxSize' trees is reserved up front
+     * so that resizing never reallocates during the run.
      */
-    void
-    setPopulation(const std::array<tree::Tree<Rtype>*, PopSize>& _population) {
-        population = _population;
+    void setSizingPolicy(SizingPolicy policy, std::size_t maxSize) {
+        sizingPolicy = policy;
+        capacity = std::max(capacity, maxSize);
+        population.reserve(capacity);
     }
 
     /*!
      * Set the mutation rate for the GA. Mutation guarantees that at least
-     * PopSize * rate individuals (not necessarily distinct) will be mutated
+     * size * rate individuals (not necessarily distinct) will be mutated
      * each generation.
      */
     void setMutationRate(float rate) { mutationRate = rate; }
 
-    const std::array<tree::Tree<Rtype>*, PopSize>& getPopulation() const {
-        return population;
+    /*!
+     * Evaluate the population on 'workers' threads (0 for one per core, 1 to
+     * evaluate serially on the calling thread). 'safety' declares whether the
+     * evaluator may be shared by the workers or must be copied per thread.
+     */
+    void setEvaluationThreads(unsigned int _workers,
+                              ThreadSafety _safety = ThreadSafety::SHARED) {
+        workers = _workers;
+        safety = _safety;
+        parallelEvaluator.reset();
+        if (workers != 1) {
+            parallelEvaluator.reset(
+                new ParallelEvaluator<Genome, Evaluator>(
+                    activeEvaluator(), workers, safety));
+        }
     }
 
     /*!
-     * Get a pointer to the historically best individual
+     * Remember the fitness of up to 'capacity' trees, keyed by their
+     * structural hash (see FitnessCache), so that copies of earlier trees
+     * are not evaluated again. The evaluator must be deterministic. A
+     * capacity of 0 disables the cache.
      */
-    const tree::Tree<Rtype>* getBest() const { return bestIndividual; }
+    void setFitnessCache(std::size_t capacity) {
+        fitnessCache.reset();
+        if (capacity != 0) {
+            fitnessCache = std::make_shared<FitnessCache<Genome>>(capacity);
+            cachedEvaluator =
+                CachedEvaluator<Genome, Evaluator>{evaluator, fitnessCache};
+        }
+        setEvaluationThreads(workers, safety);
+    }
+
+    /// The fitness cache with its hit counters, or null if disabled
+    const FitnessCache<Genome>* getFitnessCache() const {
+        return fitnessCache.get();
+    }
+
+    /*!
+     * Simplify new and mutated trees with tree::simplify before they are
+     * evaluated. Has no effect on FlatTree genomes.
+     */
+    void setSimplification(bool enabled) { simplification = enabled; }
+
+    const Population<Genome>& getPopulation() const { return population; }
+
+    /*!
+     * Get the historically best individual
+     */
+    const Genome& getBest() const { return bestIndividual; }
 
 protected:
-    std::vector<tree::Tree<Rtype>*> population;
+    using Evaluator = function<float(const Genome&)>;
+
+    tree::Tree<Rtype>* make(tree::Tree<Rtype>**) const {
+        return generator.make();
+    }
+
+    tree::FlatTree<Rtype> make(tree::FlatTree<Rtype>*) const {
+        return generator.makeFlat();
+    }
+
+    static const tree::Tree<Rtype>& print(const tree::Tree<Rtype>* tree) {
+        return *tree;
+    }
+
+    static const tree::FlatTree<Rtype>& print(
+        const tree::FlatTree<Rtype>& tree) {
+        return tree;
+    }
+
+    // Copy a tree into a recycled tree if one is available
+    Genome copyOf(const Genome& source) {
+        auto copy = population.reuse();
+        utils::copyInto(copy, source);
+        return copy;
+    }
+
+    void simplify(tree::Tree<Rtype>*& tree) const {
+        tree::simplify(*tree, generator);
+    }
+
+    void simplify(tree::FlatTree<Rtype>&) const {}
+
+    const Evaluator& activeEvaluator() const {
+        return fitnessCache ? cachedEvaluator : evaluator;
+    }
+
+    void evaluate() {
+        if (simplification) {
+            for (std::size_t i = 0; i < population.size(); ++i) {
+                if (!population[i].evaluated)
+                    simplify(population[i].genome);
+            }
+        }
+        if (parallelEvaluator) {
+            parallelEvaluator->evaluate(population);
+        } else {
+            population.evaluate(activeEvaluator());
+        }
+    }
+
+    Population<Genome> population;
     tree::TreeFactory<Rtype> generator;
 
-    tree::Tree<Rtype>* bestIndividual = nullptr; // Historically best individual
+    Genome bestIndividual{}; // Historically best individual
+    bool hasBest = false;
     double bestScore = std::numeric_limits<float>::lowest();
+    Ordering ordering = Ordering::HIGHER;
+
+    std::size_t populationSize = PopSize;
+    std::size_t capacity = PopSize;
+    SizingPolicy sizingPolicy;
+    unsigned int stagnation = 0;
+    unsigned int generation = 0;
 
-    function<float(const tree::Tree<Rtype>*)> evaluator;
+    function<float(const Genome&)> evaluator;
 
-    function<tree::Tree<Rtype>*(const tree::Tree<Rtype>*,
-                                const tree::Tree<Rtype>*)> crossover;
+    CrossoverInto crossover;
 
-    function<void(tree::Tree<Rtype>*, const tree::TreeFactory<Rtype>&)> mutator;
+    function<void(Genome&, const tree::TreeFactory<Rtype>&)> mutator;
 
-    function<void(std::vector<tree::Tree<Rtype>*>&,
-                  function<double(const tree::Tree<Rtype>*)>)> selector;
+    function<void(Population<Genome>&)> selector;
+
+    std::unique_ptr<ParallelEvaluator<Genome, Evaluator>> parallelEvaluator;
+    unsigned int workers = 1;
+    ThreadSafety safety = ThreadSafety::SHARED;
+
+    std::shared_ptr<FitnessCache<Genome>> fitnessCache;
+    Evaluator cachedEvaluator;
 
     float mutationRate = 0.6f;
+
+    bool simplification = false;
 };
 }
 
@@ -5,24 +5,98 @@
 #include <functional>
 #include <vector>
 #include <cassert>
-#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "cppEvolve/Random.hpp"
 
 namespace evolve {
 
 enum class Ordering { LOWER, HIGHER };
 
+/*!
+ * What a delta mutator did to a list genome, passed to a delta evaluator so
+ * that it can update the fitness from the positions involved
+ */
+struct Change {
+    enum Kind {
+        /// The genome is unchanged
+        NONE,
+
+        /// The alleles at 'first' and 'second' were exchanged
+        SWAP,
+
+        /// The alleles from 'first' to 'second' inclusive were reversed
+        REVERSE
+    };
+
+    Kind kind;
+    std::size_t first, second;
+};
+
 namespace utils {
 
-/*
- * Generate a random number uniformly distributed in [lower, upper)
+/// True if fitness 'a' is strictly better than fitness 'b' under 'ord'
+inline bool better(Ordering ord, double a, double b) {
+    return (ord == Ordering::HIGHER) ? a > b : a < b;
+}
+
+/// The ordering under which the least fit individuals come first
+inline Ordering reversed(Ordering ord) {
+    return (ord == Ordering::HIGHER) ? Ordering::LOWER : Ordering::HIGHER;
+}
+
+/// A fitness which every real score under 'ord' improves upon
+inline double worstFitness(Ordering ord) {
+    return (ord == Ordering::HIGHER) ? std::numeric_limits<double>::lowest()
+                                     : std::numeric_limits<double>::max();
+}
+
+/// Free a genome held by pointer. Genomes held by value need no clean up.
+template <typename T>
+void release(T*& genome) {
+    delete genome;
+    genome = nullptr;
+}
+
+template <typename T>
+void release(T&) {}
+
+/// Copy a genome. Genomes held by pointer are deep copied with clone().
+template <typename T>
+T* duplicate(T* const& genome) {
+    return genome->clone();
+}
+
+template <typename T>
+T duplicate(const T& genome) {
+    return genome;
+}
+
+/*!
+ * Make 'target' a copy of 'source', reusing the storage already held by
+ * 'target'. Genomes held by pointer are copied with assign(), or cloned if
+ * 'target' is null.
  */
-std::size_t random_uint(std::size_t lower, std::size_t upper) {
-    static std::default_random_engine e{};
-    std::uniform_int_distribution<std::size_t> d{lower, upper - 1};
-    return d(e);
+template <typename T>
+void copyInto(T*& target, T* const& source) {
+    if (target) {
+        target->assign(*source);
+    } else {
+        target = source->clone();
+    }
 }
 
-std::size_t random_uint(std::size_t upper) { return random_uint(0, upper); }
+template <typename T>
+void copyInto(T& target, const T& source) {
+    target = source;
+}
+
+/// Mix 'value' into the 64 bit hash 'seed'
+inline std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value) {
+    value *= 0x9e3779b97f4a7c15ULL;
+    return (seed ^ (value ^ (value >> 32))) * 0xbf58476d1ce4e5b9ULL;
+}
 
 template <typename T>
 struct count_args;
@@ -53,14 +127,14 @@ struct Range : public RangeHelper<Ints<bound>, bound == 0> {};
 template <typename T>
 struct unpack_caller {
 private:
-    template <typename FuncType, typename U, unsigned int... I>
-    static T call(FuncType f, const std::vector<U>& args, const Ints<I...>&) {
+    template <typename FuncType, typename Children, unsigned int... I>
+    static T call(FuncType f, const Children& args, const Ints<I...>&) {
         return f(args[I]->eval()...);
     }
 
 public:
-    template <typename FuncType, typename U>
-    static T eval(FuncType f, const std::vector<U>& args) {
+    template <typename FuncType, typename Children>
+    static T eval(FuncType f, const Children& args) {
         assert(args.size() == count_args<FuncType>::value); // just to be sure
         return call(f, args,
                     typename Range<count_args<FuncType>::value - 1>::type{});
@@ -84,6 +158,12 @@ struct sfinae_true : std::true_type {};
 
 HAS_MEMBER(operator[](std::declval<std::size_t>()), has_indexing);
 
+HAS_MEMBER(resize(std::declval<std::size_t>()), has_resize);
+
+HAS_MEMBER(reserve(std::declval<std::size_t>()), has_reserve);
+
+HAS_MEMBER(hash(), has_hash);
+
 HAS_MEMBER(push_back(std::declval<typename T::value_type>()), has_pushback);
 
 HAS_MEMBER(insert(std::declval<typename T::iterator>(),
@@ -94,6 +174,37 @@ HAS_MEMBER(insert(std::declval<typename T::iterator>(),
 HAS_MEMBER(insert(std::declval<typename T::iterator>(),
                   std::declval<typename T::value_type>()),
            has_location_insert);
+
+namespace details {
+
+template <typename Genome>
+void resize(Genome& g, std::size_t size, std::true_type) {
+    g.resize(size);
+}
+
+template <typename Genome>
+void resize(Genome&, std::size_t, std::false_type) {}
+
+template <typename Genome>
+void reserve(Genome& g, std::size_t size, std::true_type) {
+    g.reserve(size);
+}
+
+template <typename Genome>
+void reserve(Genome&, std::size_t, std::false_type) {}
+}
+
+/// Resize 'g' to the size of 'like'. Fixed size genomes are left as they are.
+template <typename Genome>
+void resizeLike(Genome& g, const Genome& like) {
+    details::resize(g, like.size(), typename has_resize<Genome>::type{});
+}
+
+/// Reserve storage for 'size' alleles in genomes which support it
+template <typename Genome>
+void reserve(Genome& g, std::size_t size) {
+    details::reserve(g, size, typename has_reserve<Genome>::type{});
+}
 }
 }
 #endif